@@ -3,9 +3,13 @@
 
 #include <chrono>
 #include <cctype>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
 #include "date.h"               // from Date via RcppDate
 #include "cctz/civil_time.h"    // from CCTZ via RcppCCTZ
 #include "cctz/time_zone.h"     // from CCTZ via RcppCCTZ
+#include "parallel.hpp"
 
 namespace nanotime {
 
@@ -184,96 +188,127 @@ namespace nanotime {
     return tmdet{y, m, d, h, mn, s, ns, tzstr_str, offset};
   }
 
-  template<int T, class TT, class I, typename getNA>
-  void subset_numeric(const Rcpp::Vector<T>& v, const I& pindx, Rcpp::Vector<T>& res, std::vector<TT>& res_c, getNA fna) {
-    if (!v.hasAttribute("names")) {
-      for (R_xlen_t i = 0; i < pindx.size(); i++) {
-        auto ii = pindx[i];
+  // hint that '*p' will soon be read:
+  inline void prefetch(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p);
+#endif
+  }
+
+  // The payload of 'x' as 'T', read through 'REAL_RO' or 'COMPLEX_RO':
+  // an Rcpp vector asks for a writable pointer, which makes a view copy
+  // its slice and clears the flag of a vector known to be sorted.
+  template <typename T>
+  inline const T* readOnly(SEXP x) {
+    if (sizeof(T) == sizeof(double) && TYPEOF(x) == REALSXP) {
+      return reinterpret_cast<const T*>(REAL_RO(x));
+    }
+    if (sizeof(T) == sizeof(Rcomplex) && TYPEOF(x) == CPLXSXP) {
+      return reinterpret_cast<const T*>(COMPLEX_RO(x));
+    }
+    Rcpp::stop("Not compatible with requested type");
+  }
+
+  // how many elements ahead of the gather to prefetch:
+  const R_xlen_t PREFETCH_DISTANCE = 16;
+
+
+  // Subsetting in two passes: the size of the result is counted
+  // first, so that the result and its names can be allocated once
+  // and filled through raw pointers; names are copied as the original
+  // 'CHARSXP', with 'NA' for the elements selected by an 'NA' or
+  // out-of-bounds index. With a numeric index the elements are a
+  // random gather, whose cost is the latency of the memory: the index
+  // is split in chunks that are counted and then gathered in
+  // parallel, each thread prefetching the elements a few iterations
+  // ahead of the one it copies.
+  template<int T, class I, typename getNA>
+  void subset_numeric(SEXP v, const I& pindx, Rcpp::Vector<T>& res, getNA fna) {
+    const auto src = readOnly<typename Rcpp::Vector<T>::stored_type>(v);
+    const R_xlen_t n = XLENGTH(v);
+    const R_xlen_t m = pindx.size();
+    const R_xlen_t nchunks = std::max(R_xlen_t(1),
+                                      std::min(static_cast<R_xlen_t>(getThreads()), m / PARALLEL_MIN_CHUNK));
+    const R_xlen_t chunk = (m + nchunks - 1) / nchunks;
+
+    // 'offset[k]' is where the elements selected by chunk 'k' go:
+    std::vector<R_xlen_t> offset(nchunks + 1, 0);
+    parallel_tasks(nchunks, [&pindx, &offset, chunk, m](R_xlen_t k) {
+      R_xlen_t len = 0;
+      for (R_xlen_t i = k * chunk; i < std::min(m, (k + 1) * chunk); i++) {
+        const auto ii = pindx[i];
         if (ii < 0) {
-          Rcpp::stop("only 0's may be mixed with negative subscripts"); // #nocov
-        }
-        if (0 < ii && ii <= v.length()) {
-          ii--;
-          res_c.push_back(v[ii]);
-        }  else if (ii != 0) { /* out of bounds or NA */
-          res_c.push_back(fna());
+          throw std::range_error("only 0's may be mixed with negative subscripts"); // #nocov
         }
+        len += ii != 0;         // NA and out of bounds give an NA element
       }
-      res = Rcpp::Vector<T>(res_c.size());
-      for (uint64_t i = 0; i < res_c.size(); i++) {
-        res[i] = res_c[i];
-      }
-    } else {
-      // repeat the code, but subsetting names at the same time:
-      const auto& names = Rcpp::CharacterVector(v.names());
-      auto names_c = std::vector<const char*>();
-      static const char* NA_STRING_LOCAL = "dummy"; // so we can keep track of NA
-      for (R_xlen_t i = 0; i < pindx.size(); i++) {
-        auto ii = pindx[i];
-        if (ii < 0) {
-          Rcpp::stop("only 0's may be mixed with negative subscripts"); // #nocov
+      offset[k + 1] = len;
+    });
+    std::partial_sum(offset.begin(), offset.end(), offset.begin());
+
+    res = Rcpp::Vector<T>(offset[nchunks]);
+    const auto na = fna();
+    const auto dst = res.begin();
+    parallel_tasks(nchunks, [&pindx, &offset, src, dst, na, chunk, m, n](R_xlen_t k) {
+      const R_xlen_t e = std::min(m, (k + 1) * chunk);
+      R_xlen_t j = offset[k];
+      for (R_xlen_t i = k * chunk; i < e; i++) {
+        if (i + PREFETCH_DISTANCE < e) {
+          const auto ip = pindx[i + PREFETCH_DISTANCE];
+          if (0 < ip && ip <= n) prefetch(&src[static_cast<R_xlen_t>(ip - 1)]);
         }
-        if (0 < ii && ii <= v.length()) {
-          ii--;
-          res_c.push_back(v[ii]);
-          names_c.push_back(Rcpp::CharacterVector::is_na(names[ii]) ? NA_STRING_LOCAL : names[ii]);
-        } else if (ii != 0) { /* out of bounds or NA */
-           res_c.push_back(fna());
-           names_c.push_back(NA_STRING_LOCAL);
+        const auto ii = pindx[i];
+        if (0 < ii && ii <= n) {
+          dst[j++] = src[static_cast<R_xlen_t>(ii - 1)];
+        } else if (ii != 0) {   // out of bounds or NA
+          dst[j++] = na;
         }
       }
-      res = Rcpp::Vector<T>(res_c.size());
-      auto res_names = Rcpp::CharacterVector(res.size());
-      for (uint32_t i = 0; i < res_c.size(); i++) {
-        res[i] = res_c[i];
-        if (names_c[i] == NA_STRING_LOCAL) {
-          res_names[i] = NA_STRING;
-        } else {
-          res_names[i] = names_c[i];
+    });
+
+    const SEXP names = Rf_getAttrib(v, R_NamesSymbol);
+    if (names != R_NilValue) {
+      Rcpp::CharacterVector res_names(res.size());
+      R_xlen_t j = 0;
+      for (R_xlen_t i = 0; i < m; i++) {
+        const auto ii = pindx[i];
+        if (0 < ii && ii <= n) {
+          SET_STRING_ELT(res_names, j++, STRING_ELT(names, static_cast<R_xlen_t>(ii - 1)));
+        } else if (ii != 0) {
+          SET_STRING_ELT(res_names, j++, NA_STRING);
         }
       }
       res.names() = res_names;
     }
   }
-  
-  template<int T, class TT, class I, typename getNA>
-  void subset_logical(const Rcpp::Vector<T>& v, const I& pindx, Rcpp::Vector<T>& res, std::vector<TT>& res_c, getNA fna) {
-   if (!v.hasAttribute("names")) {
-     for (R_xlen_t i = 0; i < v.size(); i++) {        
-        if (pindx[i] == NA_LOGICAL) {
-          res_c.push_back(fna());
-        } else if (pindx[i]) {
-          res_c.push_back(v[i]);
-        }
-      }
-      res = Rcpp::Vector<T>(res_c.size());
-      for (uint64_t i = 0; i < res_c.size(); i++) {
-        res[i] = res_c[i];
-      }
-    } else {
-      // repeat the code, but also subsetting names:
-      const auto& names = Rcpp::CharacterVector(v.names());
-      auto names_c = std::vector<const char*>();
-      static const char* NA_STRING_LOCAL = "dummy"; // so we can keep track of NA
-      for (R_xlen_t i = 0; i < v.size(); i++) {
-        if (pindx[i] == NA_LOGICAL) {
-          res_c.push_back(fna());
-          names_c.push_back(NA_STRING_LOCAL);
-        } else if (pindx[i]) {
-          res_c.push_back(v[i]);
-          names_c.push_back(names[i]);
-        }
-      }
-      res = Rcpp::Vector<T>(res_c.size());
-      auto res_names = Rcpp::CharacterVector(res.size());
-      for (uint32_t i = 0; i < res_c.size(); i++) {
-        res[i] = res_c[i];
-        if (names_c[i] == NA_STRING_LOCAL) {
-          res_names[i] = NA_STRING;
-        } else {
-          res_names[i] = names_c[i];
-        }
+
+  template<int T, class I, typename getNA>
+  void subset_logical(SEXP v, const I& pindx, Rcpp::Vector<T>& res, getNA fna) {
+    const auto src = readOnly<typename Rcpp::Vector<T>::stored_type>(v);
+    const R_xlen_t n = XLENGTH(v);
+    R_xlen_t len = 0;
+    for (R_xlen_t i = 0; i < n; i++) {
+      len += pindx[i] != 0;     // TRUE or NA
+    }
+
+    res = Rcpp::Vector<T>(len);
+    const SEXP names = Rf_getAttrib(v, R_NamesSymbol);
+    Rcpp::CharacterVector res_names(names == R_NilValue ? 0 : len);
+    const auto na = fna();
+    auto dst = res.begin();
+    R_xlen_t k = 0;
+    for (R_xlen_t i = 0; i < n; i++) {
+      if (pindx[i] == NA_LOGICAL) {
+        dst[k] = na;
+        if (names != R_NilValue) SET_STRING_ELT(res_names, k, NA_STRING);
+        ++k;
+      } else if (pindx[i]) {
+        dst[k] = src[i];
+        if (names != R_NilValue) SET_STRING_ELT(res_names, k, STRING_ELT(names, i));
+        ++k;
       }
+    }
+    if (names != R_NilValue) {
       res.names() = res_names;
     }
   }
@@ -231,6 +231,41 @@ namespace nanotime {
   }
 
 
+  // Integer keys --------------------------------------------------
+  /// The bounds of an interval mapped to integers on which open and
+  /// closed bounds compare as plain numbers: coordinates are doubled
+  /// and an open start (end) is moved one unit to the right
+  /// (left). A time 't' is in 'i' if and only if 'start_key(i) <=
+  /// time_key(t) <= end_key(i)', and two intervals overlap if and
+  /// only if the start key of each is not greater than the end key of
+  /// the other.
+  inline std::int64_t start_key(const interval& i) {
+    return 2 * i.s() + i.sopen();
+  }
+  inline std::int64_t end_key(const interval& i) {
+    return 2 * i.e() - i.eopen();
+  }
+  /// True if no time is in 'i', as for an interval such as '-1->1+'.
+  inline bool is_empty(const interval& i) {
+    return start_key(i) > end_key(i);
+  }
+  /// Times outside of the range of interval bounds are mapped just
+  /// outside the range of the interval keys.
+  inline std::int64_t time_key(const dtime& t) {
+    const auto c = t.time_since_epoch().count();
+    if (c > interval::IVAL_MAX) return 2 * interval::IVAL_MAX + 1;
+    if (c < interval::IVAL_MIN) return 2 * interval::IVAL_MIN - 1;
+    return 2 * c;
+  }
+  /// The interval whose start and end keys are 'sk' and 'ek'; the
+  /// halvings round down.
+  inline interval from_keys(std::int64_t sk, std::int64_t ek) {
+    const std::int64_t s = sk >= 0 ? sk / 2 : -((1 - sk) / 2);
+    const std::int64_t e = ek + 1 >= 0 ? (ek + 1) / 2 : -(-ek / 2);
+    return interval(dtime(duration(s)), dtime(duration(e)), sk & 1, ek & 1);
+  }
+
+
   // Unions --------------------------------------------------------
   /// In unions, we have the following rules: oo is disjoint, but oc,
   /// co, and cc touch
@@ -0,0 +1,94 @@
+#ifndef NANOTIME_PARALLEL_HPP
+#define NANOTIME_PARALLEL_HPP
+
+
+#include <thread>
+#include <vector>
+#include <exception>
+#include <algorithm>
+
+
+namespace nanotime {
+
+  // below this number of elements per thread, the cost of starting the threads is not worth it:
+  const R_xlen_t PARALLEL_MIN_CHUNK = 100000;
+
+
+  // number of threads to use, taken from the option 'nanotimeThreads' (default 1); this must
+  // be called from the main thread as it uses the R API:
+  inline int getThreads() {
+    SEXP opt = Rf_GetOption1(Rf_install("nanotimeThreads"));
+    if (opt == R_NilValue || XLENGTH(opt) != 1) return 1;
+    int nthreads = 1;
+    if (TYPEOF(opt) == INTSXP && INTEGER(opt)[0] != NA_INTEGER) {
+      nthreads = INTEGER(opt)[0];
+    } else if (TYPEOF(opt) == REALSXP && !ISNAN(REAL(opt)[0])) {
+      nthreads = static_cast<int>(std::min(REAL(opt)[0], 1024.0));
+    }
+    return std::max(nthreads, 1);
+  }
+
+
+  // call 'f(k)' for each 'k' in '[0, ntasks)', each task in its own thread; as for
+  // 'parallel_for', 'f' must not make any call to the R API, exceptions thrown by 'f' are
+  // propagated to the caller once all the tasks are done, and the threads are not kept
+  // around after the call:
+  template <typename F>
+  void parallel_tasks(R_xlen_t ntasks, F f) {
+    if (ntasks <= 1) {
+      if (ntasks == 1) f(R_xlen_t(0));
+      return;
+    }
+
+    std::vector<std::exception_ptr> errors(ntasks);
+    std::vector<std::thread> workers;
+    auto run = [&f, &errors](R_xlen_t k) {
+      try {
+        f(k);
+      } catch (...) {
+        errors[k] = std::current_exception();
+      }
+    };
+    workers.reserve(ntasks - 1);
+    R_xlen_t k = 1;
+    try {
+      for (; k<ntasks; ++k) {
+        workers.emplace_back(run, k);
+      }
+    } catch (...) {             // a thread could not be started, do the rest of the work here
+    }
+    run(0);                     // the main thread takes the first task
+    for (; k<ntasks; ++k) {
+      run(k);
+    }
+    for (auto& w : workers) w.join();
+
+    for (auto& e : errors) {
+      if (e) std::rethrow_exception(e);
+    }
+  }
+
+
+  // split '[0, n)' in contiguous chunks and call 'f(begin, end)' on each chunk, in parallel if
+  // the option 'nanotimeThreads' is larger than 1 and if 'n' is large enough. 'f' must not make
+  // any call to the R API (and in particular must not call 'Rcpp::stop'); exceptions thrown by
+  // 'f' are propagated to the caller once all the chunks are done. The threads are started for
+  // each call and are not kept around, so that a forked R process does not inherit a pool in
+  // an inconsistent state:
+  template <typename F>
+  void parallel_for(R_xlen_t n, F f) {
+    const R_xlen_t nchunks = std::min(static_cast<R_xlen_t>(getThreads()), n / PARALLEL_MIN_CHUNK);
+    if (nchunks <= 1) {
+      f(R_xlen_t(0), n);
+      return;
+    }
+
+    const R_xlen_t chunk = (n + nchunks - 1) / nchunks;
+    parallel_tasks(nchunks, [&f, chunk, n](R_xlen_t k) {
+      f(k * chunk, std::min(n, (k + 1) * chunk));
+    });
+  }
+
+} // end namespace nanotime
+
+#endif
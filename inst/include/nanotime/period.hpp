@@ -19,6 +19,17 @@ namespace nanotime {
     return duration(offset).count() * std::chrono::seconds(1);
   }
 
+  // same as above but without any call to the R API, so that it can be used from worker threads:
+  inline duration getOffsetCnvThreadSafe(const dtime& dt, const std::string& z) {
+    int offset;
+    int res = RcppCCTZ::getOffset(std::chrono::duration_cast<std::chrono::seconds>(dt.time_since_epoch()).count(), z.c_str(), offset);
+    if (res < 0) {
+      throw std::range_error("Cannot retrieve timezone '" + z + "'."); // ## nocov
+    }
+
+    return duration(offset).count() * std::chrono::seconds(1);
+  }
+
 
   struct period {
     typedef int32_t month_t ;
@@ -0,0 +1,127 @@
+#ifndef NANOTIME_RADIX_HPP
+#define NANOTIME_RADIX_HPP
+
+
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <vector>
+#include "interval.hpp"
+
+
+namespace nanotime {
+
+  // Order-preserving unsigned keys for LSD radix sorting: the keys compare as the values they
+  // are built from, so that one pass over the input replaces all the comparisons of a
+  // comparison sort.
+
+  struct RadixKey64 {
+    static const int NBYTES = 8;
+    std::uint64_t k;
+    unsigned byte(int b) const { return (k >> (8 * b)) & 0xff; }
+    bool operator<(const RadixKey64& o) const { return k < o.k; }
+    RadixKey64 operator~() const { return RadixKey64{ ~k }; }
+  };
+
+  struct RadixKey128 {
+    static const int NBYTES = 16;
+    std::uint64_t hi, lo;
+    unsigned byte(int b) const { return ((b < 8 ? lo : hi) >> (8 * (b & 7))) & 0xff; }
+    bool operator<(const RadixKey128& o) const { return hi < o.hi || (hi == o.hi && lo < o.lo); }
+    RadixKey128 operator~() const { return RadixKey128{ ~hi, ~lo }; }
+  };
+
+
+  /// The sign bit is flipped so that negative values come first; the
+  /// NA of 'integer64' is the smallest value and so sorts first.
+  inline RadixKey64 radix_key(std::int64_t x) {
+    return RadixKey64{ static_cast<std::uint64_t>(x) ^ (std::uint64_t{1} << 63) };
+  }
+
+  /// Same order as 'operator<' on 'interval': start, then a closed
+  /// start before an open one, then end, then an open end before a
+  /// closed one. Bounds are offset by 'IVAL_MIN' to be non-negative and
+  /// shifted to make room for the flag.
+  inline RadixKey128 radix_key(const interval& i) {
+    const auto s = static_cast<std::uint64_t>(i.s()) - static_cast<std::uint64_t>(interval::IVAL_MIN);
+    const auto e = static_cast<std::uint64_t>(i.e()) - static_cast<std::uint64_t>(interval::IVAL_MIN);
+    return RadixKey128{ s << 1 | i.sopen(), e << 1 | !i.eopen() };
+  }
+
+
+  /// Stable LSD radix sort of 'keys' on 8-bit digits, applying the same
+  /// permutation to 'payload'. The histograms of all the digits are
+  /// built in a single pass, and a digit that is the same for all the
+  /// keys (e.g. the high bytes of timestamps that are close together)
+  /// costs nothing; an already sorted input is detected up front.
+  template <typename KEY, typename T>
+  void radix_sort(std::vector<KEY>& keys, std::vector<T>& payload) {
+    const size_t n = keys.size();
+    size_t i = 1;
+    while (i < n && !(keys[i] < keys[i-1])) ++i;
+    if (i >= n) return;
+
+    std::vector<std::array<size_t, 256>> counts(KEY::NBYTES);
+    for (auto& c : counts) c.fill(0);
+    for (const auto& k : keys) {
+      for (int b=0; b<KEY::NBYTES; ++b) {
+        ++counts[b][k.byte(b)];
+      }
+    }
+
+    std::vector<KEY> keys2(n);
+    std::vector<T> payload2(n);
+    for (int b=0; b<KEY::NBYTES; ++b) {
+      auto& c = counts[b];
+      if (c[keys[0].byte(b)] == n) continue;
+      size_t sum = 0;
+      for (auto& x : c) {
+        const auto t = x;
+        x = sum;
+        sum += t;
+      }
+      for (size_t j=0; j<n; ++j) {
+        const auto pos = c[keys[j].byte(b)]++;
+        keys2[pos]    = keys[j];
+        payload2[pos] = payload[j];
+      }
+      keys.swap(keys2);
+      payload.swap(payload2);
+    }
+  }
+
+
+  /// 0-based permutation that stably sorts 'v' in increasing order, or
+  /// in decreasing order if 'decreasing', in which case the keys are
+  /// complemented so that ties keep their original order.
+  template <typename V>
+  std::vector<R_xlen_t> radix_order(const V* v, R_xlen_t n, bool decreasing) {
+    using KEY = decltype(radix_key(v[0]));
+    std::vector<KEY> keys(n);
+    std::vector<R_xlen_t> idx(n);
+    for (R_xlen_t i=0; i<n; ++i) {
+      keys[i] = decreasing ? ~radix_key(v[i]) : radix_key(v[i]);
+      idx[i] = i;
+    }
+    radix_sort(keys, idx);
+    return idx;
+  }
+
+
+  /// The 1-based permutation returned to R: an integer vector, as from
+  /// 'order', unless it is too long for one.
+  inline SEXP radix_permutation(const std::vector<R_xlen_t>& idx) {
+    const R_xlen_t n = idx.size();
+    if (n > INT_MAX) {
+      Rcpp::NumericVector res(n);
+      for (R_xlen_t i=0; i<n; ++i) res[i] = idx[i] + 1;
+      return res;
+    }
+    Rcpp::IntegerVector res(n);
+    for (R_xlen_t i=0; i<n; ++i) res[i] = idx[i] + 1;
+    return res;
+  }
+
+} // end namespace nanotime
+
+#endif
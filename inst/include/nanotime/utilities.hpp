@@ -117,6 +117,18 @@ namespace nanotime {
   // SunOS has no strnlen_; definition in src/strnlen.cpp
   size_t strnlen_(const char *s, size_t maxlen);
 
+  // true if 'x' is flagged as sorted, with no 'NA'; the flag is
+  // cleared by a writable pointer to 'x', which an Rcpp vector takes,
+  // so 'x' must be read through 'readOnly' beforehand; definition in
+  // src/sorted.cpp
+  bool isKnownSorted(SEXP x);
+
+  // a view on the slice of 'x' selected by 'idx' if 'idx' is a long
+  // enough range of consecutive indices within 'x', or 'R_NilValue';
+  // the view has the class and names the subset kernels would give it;
+  // definition in src/view.cpp
+  SEXP sliceView(SEXP x, SEXP idx);
+
 } // end namespace nanotime
 
 #endif
@@ -58,134 +58,260 @@ BEGIN_RCPP
 END_RCPP
 }
 // nanoduration_subset_numeric_impl
-Rcpp::NumericVector nanoduration_subset_numeric_impl(const Rcpp::NumericVector& v, const Rcpp::NumericVector& idx);
-RcppExport SEXP _nanotime_nanoduration_subset_numeric_impl(SEXP vSEXP, SEXP idxSEXP) {
+SEXP nanoduration_subset_numeric_impl(SEXP v_s, SEXP idx_s);
+RcppExport SEXP _nanotime_nanoduration_subset_numeric_impl(SEXP v_sSEXP, SEXP idx_sSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type v(vSEXP);
-    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type idx(idxSEXP);
-    rcpp_result_gen = Rcpp::wrap(nanoduration_subset_numeric_impl(v, idx));
+    Rcpp::traits::input_parameter< SEXP >::type v_s(v_sSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type idx_s(idx_sSEXP);
+    rcpp_result_gen = Rcpp::wrap(nanoduration_subset_numeric_impl(v_s, idx_s));
     return rcpp_result_gen;
 END_RCPP
 }
 // nanoduration_subset_logical_impl
-Rcpp::NumericVector nanoduration_subset_logical_impl(const Rcpp::NumericVector& v, const Rcpp::LogicalVector& idx_p);
+Rcpp::NumericVector nanoduration_subset_logical_impl(SEXP v, const Rcpp::LogicalVector& idx_p);
 RcppExport SEXP _nanotime_nanoduration_subset_logical_impl(SEXP vSEXP, SEXP idx_pSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type v(vSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type v(vSEXP);
     Rcpp::traits::input_parameter< const Rcpp::LogicalVector& >::type idx_p(idx_pSEXP);
     rcpp_result_gen = Rcpp::wrap(nanoduration_subset_logical_impl(v, idx_p));
     return rcpp_result_gen;
 END_RCPP
 }
+// nano_duplicated_impl
+Rcpp::LogicalVector nano_duplicated_impl(SEXP x, const Rcpp::LogicalVector fromLast_v);
+RcppExport SEXP _nanotime_nano_duplicated_impl(SEXP xSEXP, SEXP fromLast_vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector >::type fromLast_v(fromLast_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(nano_duplicated_impl(x, fromLast_v));
+    return rcpp_result_gen;
+END_RCPP
+}
+// nano_unique_impl
+SEXP nano_unique_impl(SEXP x, const Rcpp::LogicalVector fromLast_v);
+RcppExport SEXP _nanotime_nano_unique_impl(SEXP xSEXP, SEXP fromLast_vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector >::type fromLast_v(fromLast_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(nano_unique_impl(x, fromLast_v));
+    return rcpp_result_gen;
+END_RCPP
+}
+// nano_match_impl
+Rcpp::IntegerVector nano_match_impl(SEXP x, SEXP table, const Rcpp::IntegerVector nomatch_v);
+RcppExport SEXP _nanotime_nano_match_impl(SEXP xSEXP, SEXP tableSEXP, SEXP nomatch_vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type table(tableSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::IntegerVector >::type nomatch_v(nomatch_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(nano_match_impl(x, table, nomatch_v));
+    return rcpp_result_gen;
+END_RCPP
+}
+// nano_tabulate_impl
+Rcpp::List nano_tabulate_impl(SEXP x);
+RcppExport SEXP _nanotime_nano_tabulate_impl(SEXP xSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
+    rcpp_result_gen = Rcpp::wrap(nano_tabulate_impl(x));
+    return rcpp_result_gen;
+END_RCPP
+}
 // nanoival_intersect_idx_time_interval_impl
-Rcpp::List nanoival_intersect_idx_time_interval_impl(const Rcpp::NumericVector nv1, const Rcpp::ComplexVector nv2);
+Rcpp::List nanoival_intersect_idx_time_interval_impl(SEXP nv1, SEXP nv2);
 RcppExport SEXP _nanotime_nanoival_intersect_idx_time_interval_impl(SEXP nv1SEXP, SEXP nv2SEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::NumericVector >::type nv1(nv1SEXP);
-    Rcpp::traits::input_parameter< const Rcpp::ComplexVector >::type nv2(nv2SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nv1(nv1SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nv2(nv2SEXP);
     rcpp_result_gen = Rcpp::wrap(nanoival_intersect_idx_time_interval_impl(nv1, nv2));
     return rcpp_result_gen;
 END_RCPP
 }
 // nanoival_intersect_idx_time_interval_logical_impl
-Rcpp::LogicalVector nanoival_intersect_idx_time_interval_logical_impl(const Rcpp::NumericVector nv1, const Rcpp::ComplexVector nv2);
+Rcpp::LogicalVector nanoival_intersect_idx_time_interval_logical_impl(SEXP nv1, SEXP nv2);
 RcppExport SEXP _nanotime_nanoival_intersect_idx_time_interval_logical_impl(SEXP nv1SEXP, SEXP nv2SEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::NumericVector >::type nv1(nv1SEXP);
-    Rcpp::traits::input_parameter< const Rcpp::ComplexVector >::type nv2(nv2SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nv1(nv1SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nv2(nv2SEXP);
     rcpp_result_gen = Rcpp::wrap(nanoival_intersect_idx_time_interval_logical_impl(nv1, nv2));
     return rcpp_result_gen;
 END_RCPP
 }
+// nanoival_intersect_count_impl
+SEXP nanoival_intersect_count_impl(SEXP nv1, SEXP nv2, const Rcpp::LogicalVector bounds_v);
+RcppExport SEXP _nanotime_nanoival_intersect_count_impl(SEXP nv1SEXP, SEXP nv2SEXP, SEXP bounds_vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type nv1(nv1SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nv2(nv2SEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector >::type bounds_v(bounds_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(nanoival_intersect_count_impl(nv1, nv2, bounds_v));
+    return rcpp_result_gen;
+END_RCPP
+}
+// nanotime_asof_idx_impl
+Rcpp::NumericVector nanotime_asof_idx_impl(SEXP nv1, SEXP nv2, const Rcpp::CharacterVector roll_v, const Rcpp::NumericVector tol_v);
+RcppExport SEXP _nanotime_nanotime_asof_idx_impl(SEXP nv1SEXP, SEXP nv2SEXP, SEXP roll_vSEXP, SEXP tol_vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type nv1(nv1SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nv2(nv2SEXP);
+    Rcpp::traits::input_parameter< const Rcpp::CharacterVector >::type roll_v(roll_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector >::type tol_v(tol_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(nanotime_asof_idx_impl(nv1, nv2, roll_v, tol_v));
+    return rcpp_result_gen;
+END_RCPP
+}
+// nanoival_overlap_idx_impl
+Rcpp::List nanoival_overlap_idx_impl(SEXP cv1, SEXP cv2, const Rcpp::LogicalVector intersection_v);
+RcppExport SEXP _nanotime_nanoival_overlap_idx_impl(SEXP cv1SEXP, SEXP cv2SEXP, SEXP intersection_vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cv1(cv1SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type cv2(cv2SEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector >::type intersection_v(intersection_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(nanoival_overlap_idx_impl(cv1, cv2, intersection_v));
+    return rcpp_result_gen;
+END_RCPP
+}
 // nanoival_intersect_time_interval_impl
-Rcpp::S4 nanoival_intersect_time_interval_impl(const Rcpp::NumericVector nv1, const Rcpp::ComplexVector nv2);
+Rcpp::S4 nanoival_intersect_time_interval_impl(SEXP nv1, SEXP nv2);
 RcppExport SEXP _nanotime_nanoival_intersect_time_interval_impl(SEXP nv1SEXP, SEXP nv2SEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::NumericVector >::type nv1(nv1SEXP);
-    Rcpp::traits::input_parameter< const Rcpp::ComplexVector >::type nv2(nv2SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nv1(nv1SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nv2(nv2SEXP);
     rcpp_result_gen = Rcpp::wrap(nanoival_intersect_time_interval_impl(nv1, nv2));
     return rcpp_result_gen;
 END_RCPP
 }
 // nanoival_setdiff_time_interval_impl
-Rcpp::NumericVector nanoival_setdiff_time_interval_impl(const Rcpp::NumericVector nv1, const Rcpp::ComplexVector nv2);
+Rcpp::NumericVector nanoival_setdiff_time_interval_impl(SEXP nv1, SEXP nv2);
 RcppExport SEXP _nanotime_nanoival_setdiff_time_interval_impl(SEXP nv1SEXP, SEXP nv2SEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::NumericVector >::type nv1(nv1SEXP);
-    Rcpp::traits::input_parameter< const Rcpp::ComplexVector >::type nv2(nv2SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nv1(nv1SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nv2(nv2SEXP);
     rcpp_result_gen = Rcpp::wrap(nanoival_setdiff_time_interval_impl(nv1, nv2));
     return rcpp_result_gen;
 END_RCPP
 }
 // nanoival_union_impl
-Rcpp::ComplexVector nanoival_union_impl(const Rcpp::ComplexVector nv1, const Rcpp::ComplexVector nv2);
+Rcpp::ComplexVector nanoival_union_impl(SEXP nv1, SEXP nv2);
 RcppExport SEXP _nanotime_nanoival_union_impl(SEXP nv1SEXP, SEXP nv2SEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::ComplexVector >::type nv1(nv1SEXP);
-    Rcpp::traits::input_parameter< const Rcpp::ComplexVector >::type nv2(nv2SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nv1(nv1SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nv2(nv2SEXP);
     rcpp_result_gen = Rcpp::wrap(nanoival_union_impl(nv1, nv2));
     return rcpp_result_gen;
 END_RCPP
 }
+// nanoival_reduce_impl
+SEXP nanoival_reduce_impl(SEXP cv, const Rcpp::LogicalVector sorted_v, const Rcpp::LogicalVector mapping_v);
+RcppExport SEXP _nanotime_nanoival_reduce_impl(SEXP cvSEXP, SEXP sorted_vSEXP, SEXP mapping_vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cv(cvSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector >::type sorted_v(sorted_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector >::type mapping_v(mapping_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(nanoival_reduce_impl(cv, sorted_v, mapping_v));
+    return rcpp_result_gen;
+END_RCPP
+}
+// nanoival_cover_impl
+Rcpp::ComplexVector nanoival_cover_impl(const Rcpp::List lst, const Rcpp::NumericVector m_v);
+RcppExport SEXP _nanotime_nanoival_cover_impl(SEXP lstSEXP, SEXP m_vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::List >::type lst(lstSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector >::type m_v(m_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(nanoival_cover_impl(lst, m_v));
+    return rcpp_result_gen;
+END_RCPP
+}
+// nanoival_gaps_impl
+Rcpp::ComplexVector nanoival_gaps_impl(SEXP x, const Rcpp::ComplexVector within_v, const Rcpp::NumericVector minlen_v);
+RcppExport SEXP _nanotime_nanoival_gaps_impl(SEXP xSEXP, SEXP within_vSEXP, SEXP minlen_vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::ComplexVector >::type within_v(within_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector >::type minlen_v(minlen_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(nanoival_gaps_impl(x, within_v, minlen_v));
+    return rcpp_result_gen;
+END_RCPP
+}
 // nanoival_intersect_impl
-Rcpp::ComplexVector nanoival_intersect_impl(const Rcpp::ComplexVector nv1, const Rcpp::ComplexVector nv2);
+Rcpp::ComplexVector nanoival_intersect_impl(SEXP nv1, SEXP nv2);
 RcppExport SEXP _nanotime_nanoival_intersect_impl(SEXP nv1SEXP, SEXP nv2SEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::ComplexVector >::type nv1(nv1SEXP);
-    Rcpp::traits::input_parameter< const Rcpp::ComplexVector >::type nv2(nv2SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nv1(nv1SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nv2(nv2SEXP);
     rcpp_result_gen = Rcpp::wrap(nanoival_intersect_impl(nv1, nv2));
     return rcpp_result_gen;
 END_RCPP
 }
 // nanoival_setdiff_impl
-Rcpp::ComplexVector nanoival_setdiff_impl(const Rcpp::ComplexVector nv1, const Rcpp::ComplexVector nv2);
+Rcpp::ComplexVector nanoival_setdiff_impl(SEXP nv1, SEXP nv2);
 RcppExport SEXP _nanotime_nanoival_setdiff_impl(SEXP nv1SEXP, SEXP nv2SEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::ComplexVector >::type nv1(nv1SEXP);
-    Rcpp::traits::input_parameter< const Rcpp::ComplexVector >::type nv2(nv2SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nv1(nv1SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nv2(nv2SEXP);
     rcpp_result_gen = Rcpp::wrap(nanoival_setdiff_impl(nv1, nv2));
     return rcpp_result_gen;
 END_RCPP
 }
-// nanoival_is_unsorted_impl
-bool nanoival_is_unsorted_impl(const Rcpp::ComplexVector nvec, const Rcpp::LogicalVector strictlyvec);
-RcppExport SEXP _nanotime_nanoival_is_unsorted_impl(SEXP nvecSEXP, SEXP strictlyvecSEXP) {
+// nanoival_sort_impl
+const Rcpp::ComplexVector nanoival_sort_impl(SEXP nvec, const Rcpp::LogicalVector decreasingvec);
+RcppExport SEXP _nanotime_nanoival_sort_impl(SEXP nvecSEXP, SEXP decreasingvecSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::ComplexVector >::type nvec(nvecSEXP);
-    Rcpp::traits::input_parameter< const Rcpp::LogicalVector >::type strictlyvec(strictlyvecSEXP);
-    rcpp_result_gen = Rcpp::wrap(nanoival_is_unsorted_impl(nvec, strictlyvec));
+    Rcpp::traits::input_parameter< SEXP >::type nvec(nvecSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector >::type decreasingvec(decreasingvecSEXP);
+    rcpp_result_gen = Rcpp::wrap(nanoival_sort_impl(nvec, decreasingvec));
     return rcpp_result_gen;
 END_RCPP
 }
-// nanoival_sort_impl
-const Rcpp::ComplexVector nanoival_sort_impl(const Rcpp::ComplexVector nvec, const Rcpp::LogicalVector decreasingvec);
-RcppExport SEXP _nanotime_nanoival_sort_impl(SEXP nvecSEXP, SEXP decreasingvecSEXP) {
+// nanoival_order_impl
+SEXP nanoival_order_impl(SEXP nvec, const Rcpp::LogicalVector decreasingvec);
+RcppExport SEXP _nanotime_nanoival_order_impl(SEXP nvecSEXP, SEXP decreasingvecSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::ComplexVector >::type nvec(nvecSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nvec(nvecSEXP);
     Rcpp::traits::input_parameter< const Rcpp::LogicalVector >::type decreasingvec(decreasingvecSEXP);
-    rcpp_result_gen = Rcpp::wrap(nanoival_sort_impl(nvec, decreasingvec));
+    rcpp_result_gen = Rcpp::wrap(nanoival_order_impl(nvec, decreasingvec));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -298,17 +424,31 @@ BEGIN_RCPP
 END_RCPP
 }
 // nanoival_setdiff_idx_time_interval_impl
-Rcpp::NumericVector nanoival_setdiff_idx_time_interval_impl(const Rcpp::NumericVector nv1, const Rcpp::ComplexVector cv2);
+Rcpp::NumericVector nanoival_setdiff_idx_time_interval_impl(SEXP nv1, SEXP cv2);
 RcppExport SEXP _nanotime_nanoival_setdiff_idx_time_interval_impl(SEXP nv1SEXP, SEXP cv2SEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::NumericVector >::type nv1(nv1SEXP);
-    Rcpp::traits::input_parameter< const Rcpp::ComplexVector >::type cv2(cv2SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nv1(nv1SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type cv2(cv2SEXP);
     rcpp_result_gen = Rcpp::wrap(nanoival_setdiff_idx_time_interval_impl(nv1, cv2));
     return rcpp_result_gen;
 END_RCPP
 }
+// nanoival_pack_impl
+Rcpp::S4 nanoival_pack_impl(const Rcpp::NumericVector sv, const Rcpp::NumericVector ev, const Rcpp::LogicalVector sopenv, const Rcpp::LogicalVector eopenv);
+RcppExport SEXP _nanotime_nanoival_pack_impl(SEXP svSEXP, SEXP evSEXP, SEXP sopenvSEXP, SEXP eopenvSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector >::type sv(svSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector >::type ev(evSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector >::type sopenv(sopenvSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector >::type eopenv(eopenvSEXP);
+    rcpp_result_gen = Rcpp::wrap(nanoival_pack_impl(sv, ev, sopenv, eopenv));
+    return rcpp_result_gen;
+END_RCPP
+}
 // nanoival_new_impl
 Rcpp::S4 nanoival_new_impl(const Rcpp::NumericVector sv, const Rcpp::NumericVector ev, const Rcpp::LogicalVector sopenv, const Rcpp::LogicalVector eopenv);
 RcppExport SEXP _nanotime_nanoival_new_impl(SEXP svSEXP, SEXP evSEXP, SEXP sopenvSEXP, SEXP eopenvSEXP) {
@@ -323,6 +463,17 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// nanoival_unpack_impl
+Rcpp::List nanoival_unpack_impl(const Rcpp::ComplexVector cv);
+RcppExport SEXP _nanotime_nanoival_unpack_impl(SEXP cvSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::ComplexVector >::type cv(cvSEXP);
+    rcpp_result_gen = Rcpp::wrap(nanoival_unpack_impl(cv));
+    return rcpp_result_gen;
+END_RCPP
+}
 // nanoival_get_start_impl
 Rcpp::NumericVector nanoival_get_start_impl(const Rcpp::ComplexVector cv);
 RcppExport SEXP _nanotime_nanoival_get_start_impl(SEXP cvSEXP) {
@@ -391,29 +542,66 @@ BEGIN_RCPP
 END_RCPP
 }
 // nanoival_subset_numeric_impl
-Rcpp::ComplexVector nanoival_subset_numeric_impl(const Rcpp::ComplexVector& v, const Rcpp::NumericVector& idx);
-RcppExport SEXP _nanotime_nanoival_subset_numeric_impl(SEXP vSEXP, SEXP idxSEXP) {
+SEXP nanoival_subset_numeric_impl(SEXP v_s, SEXP idx_s);
+RcppExport SEXP _nanotime_nanoival_subset_numeric_impl(SEXP v_sSEXP, SEXP idx_sSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::ComplexVector& >::type v(vSEXP);
-    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type idx(idxSEXP);
-    rcpp_result_gen = Rcpp::wrap(nanoival_subset_numeric_impl(v, idx));
+    Rcpp::traits::input_parameter< SEXP >::type v_s(v_sSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type idx_s(idx_sSEXP);
+    rcpp_result_gen = Rcpp::wrap(nanoival_subset_numeric_impl(v_s, idx_s));
     return rcpp_result_gen;
 END_RCPP
 }
 // nanoival_subset_logical_impl
-Rcpp::ComplexVector nanoival_subset_logical_impl(const Rcpp::ComplexVector& v, const Rcpp::LogicalVector& idx_p);
+Rcpp::ComplexVector nanoival_subset_logical_impl(SEXP v, const Rcpp::LogicalVector& idx_p);
 RcppExport SEXP _nanotime_nanoival_subset_logical_impl(SEXP vSEXP, SEXP idx_pSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::ComplexVector& >::type v(vSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type v(vSEXP);
     Rcpp::traits::input_parameter< const Rcpp::LogicalVector& >::type idx_p(idx_pSEXP);
     rcpp_result_gen = Rcpp::wrap(nanoival_subset_logical_impl(v, idx_p));
     return rcpp_result_gen;
 END_RCPP
 }
+// nanoival_index_impl
+SEXP nanoival_index_impl(const Rcpp::ComplexVector cv);
+RcppExport SEXP _nanotime_nanoival_index_impl(SEXP cvSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::ComplexVector >::type cv(cvSEXP);
+    rcpp_result_gen = Rcpp::wrap(nanoival_index_impl(cv));
+    return rcpp_result_gen;
+END_RCPP
+}
+// nanoival_stab_time_impl
+SEXP nanoival_stab_time_impl(SEXP xp, const Rcpp::NumericVector nv, const Rcpp::LogicalVector count_v);
+RcppExport SEXP _nanotime_nanoival_stab_time_impl(SEXP xpSEXP, SEXP nvSEXP, SEXP count_vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type xp(xpSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector >::type nv(nvSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector >::type count_v(count_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(nanoival_stab_time_impl(xp, nv, count_v));
+    return rcpp_result_gen;
+END_RCPP
+}
+// nanoival_stab_interval_impl
+SEXP nanoival_stab_interval_impl(SEXP xp, const Rcpp::ComplexVector cv, const Rcpp::LogicalVector count_v);
+RcppExport SEXP _nanotime_nanoival_stab_interval_impl(SEXP xpSEXP, SEXP cvSEXP, SEXP count_vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type xp(xpSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::ComplexVector >::type cv(cvSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector >::type count_v(count_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(nanoival_stab_interval_impl(xp, cv, count_v));
+    return rcpp_result_gen;
+END_RCPP
+}
 // nanotime_wday_impl
 Rcpp::IntegerVector nanotime_wday_impl(const Rcpp::NumericVector tm_v, const Rcpp::CharacterVector tz_v);
 RcppExport SEXP _nanotime_nanotime_wday_impl(SEXP tm_vSEXP, SEXP tz_vSEXP) {
@@ -475,24 +663,24 @@ BEGIN_RCPP
 END_RCPP
 }
 // nanotime_subset_numeric_impl
-Rcpp::NumericVector nanotime_subset_numeric_impl(const Rcpp::NumericVector& v, const Rcpp::NumericVector& idx);
-RcppExport SEXP _nanotime_nanotime_subset_numeric_impl(SEXP vSEXP, SEXP idxSEXP) {
+SEXP nanotime_subset_numeric_impl(SEXP v_s, SEXP idx_s);
+RcppExport SEXP _nanotime_nanotime_subset_numeric_impl(SEXP v_sSEXP, SEXP idx_sSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type v(vSEXP);
-    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type idx(idxSEXP);
-    rcpp_result_gen = Rcpp::wrap(nanotime_subset_numeric_impl(v, idx));
+    Rcpp::traits::input_parameter< SEXP >::type v_s(v_sSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type idx_s(idx_sSEXP);
+    rcpp_result_gen = Rcpp::wrap(nanotime_subset_numeric_impl(v_s, idx_s));
     return rcpp_result_gen;
 END_RCPP
 }
 // nanotime_subset_logical_impl
-Rcpp::NumericVector nanotime_subset_logical_impl(const Rcpp::NumericVector& v, const Rcpp::LogicalVector& idx_p);
+Rcpp::NumericVector nanotime_subset_logical_impl(SEXP v, const Rcpp::LogicalVector& idx_p);
 RcppExport SEXP _nanotime_nanotime_subset_logical_impl(SEXP vSEXP, SEXP idx_pSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type v(vSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type v(vSEXP);
     Rcpp::traits::input_parameter< const Rcpp::LogicalVector& >::type idx_p(idx_pSEXP);
     rcpp_result_gen = Rcpp::wrap(nanotime_subset_logical_impl(v, idx_p));
     return rcpp_result_gen;
@@ -834,80 +1022,219 @@ BEGIN_RCPP
 END_RCPP
 }
 // period_subset_numeric_impl
-Rcpp::ComplexVector period_subset_numeric_impl(const Rcpp::ComplexVector& v, const Rcpp::NumericVector& idx);
-RcppExport SEXP _nanotime_period_subset_numeric_impl(SEXP vSEXP, SEXP idxSEXP) {
+SEXP period_subset_numeric_impl(SEXP v_s, SEXP idx_s);
+RcppExport SEXP _nanotime_period_subset_numeric_impl(SEXP v_sSEXP, SEXP idx_sSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::ComplexVector& >::type v(vSEXP);
-    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type idx(idxSEXP);
-    rcpp_result_gen = Rcpp::wrap(period_subset_numeric_impl(v, idx));
+    Rcpp::traits::input_parameter< SEXP >::type v_s(v_sSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type idx_s(idx_sSEXP);
+    rcpp_result_gen = Rcpp::wrap(period_subset_numeric_impl(v_s, idx_s));
     return rcpp_result_gen;
 END_RCPP
 }
 // period_subset_logical_impl
-Rcpp::ComplexVector period_subset_logical_impl(const Rcpp::ComplexVector& v, const Rcpp::LogicalVector& idx_p);
+Rcpp::ComplexVector period_subset_logical_impl(SEXP v, const Rcpp::LogicalVector& idx_p);
 RcppExport SEXP _nanotime_period_subset_logical_impl(SEXP vSEXP, SEXP idx_pSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::ComplexVector& >::type v(vSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type v(vSEXP);
     Rcpp::traits::input_parameter< const Rcpp::LogicalVector& >::type idx_p(idx_pSEXP);
     rcpp_result_gen = Rcpp::wrap(period_subset_logical_impl(v, idx_p));
     return rcpp_result_gen;
 END_RCPP
 }
+// rolling_impl
+Rcpp::List rolling_impl(SEXP nt_s, const Rcpp::NumericVector& dur_v, const Rcpp::List& cols, const Rcpp::CharacterVector& stats_v, const Rcpp::LogicalVector& sopen_v, const Rcpp::LogicalVector& eopen_v);
+RcppExport SEXP _nanotime_rolling_impl(SEXP nt_sSEXP, SEXP dur_vSEXP, SEXP colsSEXP, SEXP stats_vSEXP, SEXP sopen_vSEXP, SEXP eopen_vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type nt_s(nt_sSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type dur_v(dur_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::List& >::type cols(colsSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::CharacterVector& >::type stats_v(stats_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector& >::type sopen_v(sopen_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector& >::type eopen_v(eopen_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(rolling_impl(nt_s, dur_v, cols, stats_v, sopen_v, eopen_v));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rolling_tz_impl
+Rcpp::List rolling_tz_impl(SEXP nt_s, const Rcpp::ComplexVector& prd_v, const Rcpp::List& cols, const Rcpp::CharacterVector& stats_v, const Rcpp::LogicalVector& sopen_v, const Rcpp::LogicalVector& eopen_v, const Rcpp::CharacterVector& tz_v);
+RcppExport SEXP _nanotime_rolling_tz_impl(SEXP nt_sSEXP, SEXP prd_vSEXP, SEXP colsSEXP, SEXP stats_vSEXP, SEXP sopen_vSEXP, SEXP eopen_vSEXP, SEXP tz_vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type nt_s(nt_sSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::ComplexVector& >::type prd_v(prd_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::List& >::type cols(colsSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::CharacterVector& >::type stats_v(stats_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector& >::type sopen_v(sopen_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector& >::type eopen_v(eopen_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::CharacterVector& >::type tz_v(tz_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(rolling_tz_impl(nt_s, prd_v, cols, stats_v, sopen_v, eopen_v, tz_v));
+    return rcpp_result_gen;
+END_RCPP
+}
 // ceiling_tz_impl
-Rcpp::NumericVector ceiling_tz_impl(const Rcpp::NumericVector& nt_v, const Rcpp::ComplexVector& prd_v, const Rcpp::NumericVector& orig_v, const Rcpp::CharacterVector& tz_v);
-RcppExport SEXP _nanotime_ceiling_tz_impl(SEXP nt_vSEXP, SEXP prd_vSEXP, SEXP orig_vSEXP, SEXP tz_vSEXP) {
+Rcpp::NumericVector ceiling_tz_impl(SEXP nt_s, const Rcpp::ComplexVector& prd_v, const Rcpp::NumericVector& orig_v, const Rcpp::CharacterVector& tz_v, const Rcpp::IntegerVector& week_start_v, const Rcpp::LogicalVector& epoch_v);
+RcppExport SEXP _nanotime_ceiling_tz_impl(SEXP nt_sSEXP, SEXP prd_vSEXP, SEXP orig_vSEXP, SEXP tz_vSEXP, SEXP week_start_vSEXP, SEXP epoch_vSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type nt_v(nt_vSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nt_s(nt_sSEXP);
     Rcpp::traits::input_parameter< const Rcpp::ComplexVector& >::type prd_v(prd_vSEXP);
     Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type orig_v(orig_vSEXP);
     Rcpp::traits::input_parameter< const Rcpp::CharacterVector& >::type tz_v(tz_vSEXP);
-    rcpp_result_gen = Rcpp::wrap(ceiling_tz_impl(nt_v, prd_v, orig_v, tz_v));
+    Rcpp::traits::input_parameter< const Rcpp::IntegerVector& >::type week_start_v(week_start_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector& >::type epoch_v(epoch_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(ceiling_tz_impl(nt_s, prd_v, orig_v, tz_v, week_start_v, epoch_v));
     return rcpp_result_gen;
 END_RCPP
 }
 // ceiling_impl
-Rcpp::NumericVector ceiling_impl(const Rcpp::NumericVector& nt_v, const Rcpp::NumericVector& dur_v, const Rcpp::NumericVector& orig_v);
-RcppExport SEXP _nanotime_ceiling_impl(SEXP nt_vSEXP, SEXP dur_vSEXP, SEXP orig_vSEXP) {
+Rcpp::NumericVector ceiling_impl(SEXP nt_s, const Rcpp::NumericVector& dur_v, const Rcpp::NumericVector& orig_v);
+RcppExport SEXP _nanotime_ceiling_impl(SEXP nt_sSEXP, SEXP dur_vSEXP, SEXP orig_vSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type nt_v(nt_vSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nt_s(nt_sSEXP);
     Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type dur_v(dur_vSEXP);
     Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type orig_v(orig_vSEXP);
-    rcpp_result_gen = Rcpp::wrap(ceiling_impl(nt_v, dur_v, orig_v));
+    rcpp_result_gen = Rcpp::wrap(ceiling_impl(nt_s, dur_v, orig_v));
     return rcpp_result_gen;
 END_RCPP
 }
 // floor_tz_impl
-Rcpp::NumericVector floor_tz_impl(const Rcpp::NumericVector& nt_v, const Rcpp::ComplexVector& prd_v, const Rcpp::NumericVector& orig_v, const Rcpp::CharacterVector& tz_v);
-RcppExport SEXP _nanotime_floor_tz_impl(SEXP nt_vSEXP, SEXP prd_vSEXP, SEXP orig_vSEXP, SEXP tz_vSEXP) {
+Rcpp::NumericVector floor_tz_impl(SEXP nt_s, const Rcpp::ComplexVector& prd_v, const Rcpp::NumericVector& orig_v, const Rcpp::CharacterVector& tz_v, const Rcpp::IntegerVector& week_start_v, const Rcpp::LogicalVector& epoch_v);
+RcppExport SEXP _nanotime_floor_tz_impl(SEXP nt_sSEXP, SEXP prd_vSEXP, SEXP orig_vSEXP, SEXP tz_vSEXP, SEXP week_start_vSEXP, SEXP epoch_vSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type nt_v(nt_vSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nt_s(nt_sSEXP);
     Rcpp::traits::input_parameter< const Rcpp::ComplexVector& >::type prd_v(prd_vSEXP);
     Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type orig_v(orig_vSEXP);
     Rcpp::traits::input_parameter< const Rcpp::CharacterVector& >::type tz_v(tz_vSEXP);
-    rcpp_result_gen = Rcpp::wrap(floor_tz_impl(nt_v, prd_v, orig_v, tz_v));
+    Rcpp::traits::input_parameter< const Rcpp::IntegerVector& >::type week_start_v(week_start_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector& >::type epoch_v(epoch_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(floor_tz_impl(nt_s, prd_v, orig_v, tz_v, week_start_v, epoch_v));
     return rcpp_result_gen;
 END_RCPP
 }
 // floor_impl
-Rcpp::NumericVector floor_impl(const Rcpp::NumericVector& nt_v, const Rcpp::NumericVector& dur_v, const Rcpp::NumericVector& orig_v);
-RcppExport SEXP _nanotime_floor_impl(SEXP nt_vSEXP, SEXP dur_vSEXP, SEXP orig_vSEXP) {
+Rcpp::NumericVector floor_impl(SEXP nt_s, const Rcpp::NumericVector& dur_v, const Rcpp::NumericVector& orig_v);
+RcppExport SEXP _nanotime_floor_impl(SEXP nt_sSEXP, SEXP dur_vSEXP, SEXP orig_vSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type nt_v(nt_vSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type nt_s(nt_sSEXP);
     Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type dur_v(dur_vSEXP);
     Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type orig_v(orig_vSEXP);
-    rcpp_result_gen = Rcpp::wrap(floor_impl(nt_v, dur_v, orig_v));
+    rcpp_result_gen = Rcpp::wrap(floor_impl(nt_s, dur_v, orig_v));
+    return rcpp_result_gen;
+END_RCPP
+}
+// floor_idx_impl
+Rcpp::List floor_idx_impl(SEXP nt_s, const Rcpp::NumericVector& dur_v, const Rcpp::NumericVector& orig_v, const Rcpp::LogicalVector& int64_v);
+RcppExport SEXP _nanotime_floor_idx_impl(SEXP nt_sSEXP, SEXP dur_vSEXP, SEXP orig_vSEXP, SEXP int64_vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type nt_s(nt_sSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type dur_v(dur_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type orig_v(orig_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector& >::type int64_v(int64_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(floor_idx_impl(nt_s, dur_v, orig_v, int64_v));
+    return rcpp_result_gen;
+END_RCPP
+}
+// floor_tz_idx_impl
+Rcpp::List floor_tz_idx_impl(SEXP nt_s, const Rcpp::ComplexVector& prd_v, const Rcpp::NumericVector& orig_v, const Rcpp::CharacterVector& tz_v, const Rcpp::IntegerVector& week_start_v, const Rcpp::LogicalVector& epoch_v, const Rcpp::LogicalVector& int64_v);
+RcppExport SEXP _nanotime_floor_tz_idx_impl(SEXP nt_sSEXP, SEXP prd_vSEXP, SEXP orig_vSEXP, SEXP tz_vSEXP, SEXP week_start_vSEXP, SEXP epoch_vSEXP, SEXP int64_vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type nt_s(nt_sSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::ComplexVector& >::type prd_v(prd_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type orig_v(orig_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::CharacterVector& >::type tz_v(tz_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::IntegerVector& >::type week_start_v(week_start_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector& >::type epoch_v(epoch_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector& >::type int64_v(int64_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(floor_tz_idx_impl(nt_s, prd_v, orig_v, tz_v, week_start_v, epoch_v, int64_v));
+    return rcpp_result_gen;
+END_RCPP
+}
+// nanotime_sort_impl
+Rcpp::NumericVector nanotime_sort_impl(SEXP nv, const Rcpp::LogicalVector decreasing_v, const Rcpp::LogicalVector na_last_v);
+RcppExport SEXP _nanotime_nanotime_sort_impl(SEXP nvSEXP, SEXP decreasing_vSEXP, SEXP na_last_vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type nv(nvSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector >::type decreasing_v(decreasing_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector >::type na_last_v(na_last_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(nanotime_sort_impl(nv, decreasing_v, na_last_v));
+    return rcpp_result_gen;
+END_RCPP
+}
+// nanotime_order_impl
+SEXP nanotime_order_impl(SEXP nv, const Rcpp::LogicalVector decreasing_v, const Rcpp::LogicalVector na_last_v);
+RcppExport SEXP _nanotime_nanotime_order_impl(SEXP nvSEXP, SEXP decreasing_vSEXP, SEXP na_last_vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type nv(nvSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector >::type decreasing_v(decreasing_vSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector >::type na_last_v(na_last_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(nanotime_order_impl(nv, decreasing_v, na_last_v));
+    return rcpp_result_gen;
+END_RCPP
+}
+// nano_is_sorted_impl
+bool nano_is_sorted_impl(SEXP x);
+RcppExport SEXP _nanotime_nano_is_sorted_impl(SEXP xSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
+    rcpp_result_gen = Rcpp::wrap(nano_is_sorted_impl(x));
+    return rcpp_result_gen;
+END_RCPP
+}
+// nano_first_unsorted_impl
+SEXP nano_first_unsorted_impl(SEXP x, const Rcpp::LogicalVector strictly_v);
+RcppExport SEXP _nanotime_nano_first_unsorted_impl(SEXP xSEXP, SEXP strictly_vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::LogicalVector >::type strictly_v(strictly_vSEXP);
+    rcpp_result_gen = Rcpp::wrap(nano_first_unsorted_impl(x, strictly_v));
+    return rcpp_result_gen;
+END_RCPP
+}
+// nano_mark_sorted_impl
+SEXP nano_mark_sorted_impl(SEXP x);
+RcppExport SEXP _nanotime_nano_mark_sorted_impl(SEXP xSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
+    rcpp_result_gen = Rcpp::wrap(nano_mark_sorted_impl(x));
+    return rcpp_result_gen;
+END_RCPP
+}
+// nano_is_view_impl
+bool nano_is_view_impl(SEXP x);
+RcppExport SEXP _nanotime_nano_is_view_impl(SEXP xSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
+    rcpp_result_gen = Rcpp::wrap(nano_is_view_impl(x));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -919,15 +1246,25 @@ static const R_CallMethodDef CallEntries[] = {
     {"_nanotime_make_duration_impl", (DL_FUNC) &_nanotime_make_duration_impl, 4},
     {"_nanotime_nanoduration_subset_numeric_impl", (DL_FUNC) &_nanotime_nanoduration_subset_numeric_impl, 2},
     {"_nanotime_nanoduration_subset_logical_impl", (DL_FUNC) &_nanotime_nanoduration_subset_logical_impl, 2},
+    {"_nanotime_nano_duplicated_impl", (DL_FUNC) &_nanotime_nano_duplicated_impl, 2},
+    {"_nanotime_nano_unique_impl", (DL_FUNC) &_nanotime_nano_unique_impl, 2},
+    {"_nanotime_nano_match_impl", (DL_FUNC) &_nanotime_nano_match_impl, 3},
+    {"_nanotime_nano_tabulate_impl", (DL_FUNC) &_nanotime_nano_tabulate_impl, 1},
     {"_nanotime_nanoival_intersect_idx_time_interval_impl", (DL_FUNC) &_nanotime_nanoival_intersect_idx_time_interval_impl, 2},
     {"_nanotime_nanoival_intersect_idx_time_interval_logical_impl", (DL_FUNC) &_nanotime_nanoival_intersect_idx_time_interval_logical_impl, 2},
+    {"_nanotime_nanoival_intersect_count_impl", (DL_FUNC) &_nanotime_nanoival_intersect_count_impl, 3},
+    {"_nanotime_nanotime_asof_idx_impl", (DL_FUNC) &_nanotime_nanotime_asof_idx_impl, 4},
+    {"_nanotime_nanoival_overlap_idx_impl", (DL_FUNC) &_nanotime_nanoival_overlap_idx_impl, 3},
     {"_nanotime_nanoival_intersect_time_interval_impl", (DL_FUNC) &_nanotime_nanoival_intersect_time_interval_impl, 2},
     {"_nanotime_nanoival_setdiff_time_interval_impl", (DL_FUNC) &_nanotime_nanoival_setdiff_time_interval_impl, 2},
     {"_nanotime_nanoival_union_impl", (DL_FUNC) &_nanotime_nanoival_union_impl, 2},
+    {"_nanotime_nanoival_reduce_impl", (DL_FUNC) &_nanotime_nanoival_reduce_impl, 3},
+    {"_nanotime_nanoival_cover_impl", (DL_FUNC) &_nanotime_nanoival_cover_impl, 2},
+    {"_nanotime_nanoival_gaps_impl", (DL_FUNC) &_nanotime_nanoival_gaps_impl, 3},
     {"_nanotime_nanoival_intersect_impl", (DL_FUNC) &_nanotime_nanoival_intersect_impl, 2},
     {"_nanotime_nanoival_setdiff_impl", (DL_FUNC) &_nanotime_nanoival_setdiff_impl, 2},
-    {"_nanotime_nanoival_is_unsorted_impl", (DL_FUNC) &_nanotime_nanoival_is_unsorted_impl, 2},
     {"_nanotime_nanoival_sort_impl", (DL_FUNC) &_nanotime_nanoival_sort_impl, 2},
+    {"_nanotime_nanoival_order_impl", (DL_FUNC) &_nanotime_nanoival_order_impl, 2},
     {"_nanotime_nanoival_sort_impl2", (DL_FUNC) &_nanotime_nanoival_sort_impl2, 2},
     {"_nanotime_nanoival_lt_impl", (DL_FUNC) &_nanotime_nanoival_lt_impl, 2},
     {"_nanotime_nanoival_le_impl", (DL_FUNC) &_nanotime_nanoival_le_impl, 2},
@@ -938,7 +1275,9 @@ static const R_CallMethodDef CallEntries[] = {
     {"_nanotime_nanoival_plus_impl", (DL_FUNC) &_nanotime_nanoival_plus_impl, 2},
     {"_nanotime_nanoival_minus_impl", (DL_FUNC) &_nanotime_nanoival_minus_impl, 2},
     {"_nanotime_nanoival_setdiff_idx_time_interval_impl", (DL_FUNC) &_nanotime_nanoival_setdiff_idx_time_interval_impl, 2},
+    {"_nanotime_nanoival_pack_impl", (DL_FUNC) &_nanotime_nanoival_pack_impl, 4},
     {"_nanotime_nanoival_new_impl", (DL_FUNC) &_nanotime_nanoival_new_impl, 4},
+    {"_nanotime_nanoival_unpack_impl", (DL_FUNC) &_nanotime_nanoival_unpack_impl, 1},
     {"_nanotime_nanoival_get_start_impl", (DL_FUNC) &_nanotime_nanoival_get_start_impl, 1},
     {"_nanotime_nanoival_get_end_impl", (DL_FUNC) &_nanotime_nanoival_get_end_impl, 1},
     {"_nanotime_nanoival_get_sopen_impl", (DL_FUNC) &_nanotime_nanoival_get_sopen_impl, 1},
@@ -947,6 +1286,9 @@ static const R_CallMethodDef CallEntries[] = {
     {"_nanotime_nanoival_make_impl", (DL_FUNC) &_nanotime_nanoival_make_impl, 2},
     {"_nanotime_nanoival_subset_numeric_impl", (DL_FUNC) &_nanotime_nanoival_subset_numeric_impl, 2},
     {"_nanotime_nanoival_subset_logical_impl", (DL_FUNC) &_nanotime_nanoival_subset_logical_impl, 2},
+    {"_nanotime_nanoival_index_impl", (DL_FUNC) &_nanotime_nanoival_index_impl, 1},
+    {"_nanotime_nanoival_stab_time_impl", (DL_FUNC) &_nanotime_nanoival_stab_time_impl, 3},
+    {"_nanotime_nanoival_stab_interval_impl", (DL_FUNC) &_nanotime_nanoival_stab_interval_impl, 3},
     {"_nanotime_nanotime_wday_impl", (DL_FUNC) &_nanotime_nanotime_wday_impl, 2},
     {"_nanotime_nanotime_mday_impl", (DL_FUNC) &_nanotime_nanotime_mday_impl, 2},
     {"_nanotime_nanotime_month_impl", (DL_FUNC) &_nanotime_nanotime_month_impl, 2},
@@ -984,14 +1326,28 @@ static const R_CallMethodDef CallEntries[] = {
     {"_nanotime_period_seq_from_length_impl", (DL_FUNC) &_nanotime_period_seq_from_length_impl, 4},
     {"_nanotime_period_subset_numeric_impl", (DL_FUNC) &_nanotime_period_subset_numeric_impl, 2},
     {"_nanotime_period_subset_logical_impl", (DL_FUNC) &_nanotime_period_subset_logical_impl, 2},
-    {"_nanotime_ceiling_tz_impl", (DL_FUNC) &_nanotime_ceiling_tz_impl, 4},
+    {"_nanotime_rolling_impl", (DL_FUNC) &_nanotime_rolling_impl, 6},
+    {"_nanotime_rolling_tz_impl", (DL_FUNC) &_nanotime_rolling_tz_impl, 7},
+    {"_nanotime_ceiling_tz_impl", (DL_FUNC) &_nanotime_ceiling_tz_impl, 6},
     {"_nanotime_ceiling_impl", (DL_FUNC) &_nanotime_ceiling_impl, 3},
-    {"_nanotime_floor_tz_impl", (DL_FUNC) &_nanotime_floor_tz_impl, 4},
+    {"_nanotime_floor_tz_impl", (DL_FUNC) &_nanotime_floor_tz_impl, 6},
     {"_nanotime_floor_impl", (DL_FUNC) &_nanotime_floor_impl, 3},
+    {"_nanotime_floor_idx_impl", (DL_FUNC) &_nanotime_floor_idx_impl, 4},
+    {"_nanotime_floor_tz_idx_impl", (DL_FUNC) &_nanotime_floor_tz_idx_impl, 7},
+    {"_nanotime_nanotime_sort_impl", (DL_FUNC) &_nanotime_nanotime_sort_impl, 3},
+    {"_nanotime_nanotime_order_impl", (DL_FUNC) &_nanotime_nanotime_order_impl, 3},
+    {"_nanotime_nano_is_sorted_impl", (DL_FUNC) &_nanotime_nano_is_sorted_impl, 1},
+    {"_nanotime_nano_first_unsorted_impl", (DL_FUNC) &_nanotime_nano_first_unsorted_impl, 2},
+    {"_nanotime_nano_mark_sorted_impl", (DL_FUNC) &_nanotime_nano_mark_sorted_impl, 1},
+    {"_nanotime_nano_is_view_impl", (DL_FUNC) &_nanotime_nano_is_view_impl, 1},
     {NULL, NULL, 0}
 };
 
+void nanotime_init_sorted(DllInfo* dll);
+void nanotime_init_view(DllInfo* dll);
 RcppExport void R_init_nanotime(DllInfo *dll) {
     R_registerRoutines(dll, NULL, CallEntries, NULL, NULL);
     R_useDynamicSymbols(dll, FALSE);
+    nanotime_init_sorted(dll);
+    nanotime_init_view(dll);
 }
@@ -199,19 +199,21 @@ static double getNA_nanoduration() {
 
 
 // [[Rcpp::export]]
-Rcpp::NumericVector nanoduration_subset_numeric_impl(const Rcpp::NumericVector& v, const Rcpp::NumericVector& idx) {
+SEXP nanoduration_subset_numeric_impl(SEXP v_s, SEXP idx_s) {
+  // a contiguous range of indices gives a view that shares the data of 'v':
+  const SEXP view = sliceView(v_s, idx_s);
+  if (view != R_NilValue) return view;
+  const Rcpp::NumericVector idx(idx_s);
   Rcpp::NumericVector res(0);
-  std::vector<double> res_c;    // by declaring it here we can make subset logical agnostic to double
-  subset_numeric(v, idx, res, res_c, getNA_nanoduration);
+  subset_numeric(v_s, idx, res, getNA_nanoduration);
   return assignS4("nanoduration", res, "integer64");
 }
 
 
 // [[Rcpp::export]]
-Rcpp::NumericVector nanoduration_subset_logical_impl(const Rcpp::NumericVector& v, const Rcpp::LogicalVector& idx_p) {
+Rcpp::NumericVector nanoduration_subset_logical_impl(SEXP v, const Rcpp::LogicalVector& idx_p) {
   const ConstPseudoVectorLgl idx(idx_p);
   Rcpp::NumericVector res(0);
-  std::vector<double> res_c;    // by declaring it here we can make subset logical agnostic to double
-  subset_logical(v, idx, res, res_c, getNA_nanoduration);
+  subset_logical(v, idx, res, getNA_nanoduration);
   return assignS4("nanoduration", res, "integer64");
 }
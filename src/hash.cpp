@@ -0,0 +1,242 @@
+#include <climits>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include <Rcpp.h>
+#include "nanotime/globals.hpp"
+#include "nanotime/interval.hpp"
+#include "nanotime/period.hpp"
+
+
+using namespace nanotime;
+
+
+// Hash-based 'unique', 'duplicated', 'match' and counts for the four
+// nanotime classes. Elements are hashed on their raw payload: 64 bits
+// for 'nanotime' and 'nanoduration', 128 bits for 'nanoival' and
+// 'nanoperiod'. The payload is never read as a double or a complex,
+// whose NaN patterns would not compare equal to themselves.
+
+enum NanoKind { NANOTIME, NANODURATION, NANOIVAL, NANOPERIOD };
+
+static NanoKind getKind(SEXP x) {
+  if (TYPEOF(x) == REALSXP && Rf_inherits(x, "nanotime"))     return NANOTIME;
+  if (TYPEOF(x) == REALSXP && Rf_inherits(x, "nanoduration")) return NANODURATION;
+  if (TYPEOF(x) == CPLXSXP && Rf_inherits(x, "nanoival"))     return NANOIVAL;
+  if (TYPEOF(x) == CPLXSXP && Rf_inherits(x, "nanoperiod"))   return NANOPERIOD;
+  Rcpp::stop("argument must be a 'nanotime', 'nanoduration', 'nanoival' or 'nanoperiod'");
+}
+
+
+struct Key128 {
+  std::uint64_t lo, hi;
+  bool operator==(const Key128& k) const { return lo == k.lo && hi == k.hi; }
+};
+
+static inline std::uint64_t mix(std::uint64_t h) {
+  // finalizer of 'splitmix64':
+  h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 27; h *= 0x94d049bb133111ebULL;
+  h ^= h >> 31;
+  return h;
+}
+static inline std::uint64_t hashKey(std::uint64_t k) { return mix(k); }
+static inline std::uint64_t hashKey(const Key128& k) { return mix(k.lo ^ mix(k.hi)); }
+
+
+// the keys of 'x', with all the NA of a class mapped to the same key;
+// for 'nanoival' and 'nanoperiod' this must agree with 'isNA()':
+static std::vector<std::uint64_t> getKeys64(SEXP x) {
+  const R_xlen_t n = XLENGTH(x);
+  std::vector<std::uint64_t> keys(n);
+  if (n) memcpy(keys.data(), REAL(x), n * sizeof(std::uint64_t));
+  return keys;
+}
+
+static std::vector<Key128> getKeys128(SEXP x, NanoKind kind) {
+  const R_xlen_t n = XLENGTH(x);
+  std::vector<Key128> keys(n);
+  if (n) memcpy(keys.data(), COMPLEX(x), n * sizeof(Key128));
+  if (kind == NANOIVAL) {
+    const interval* v = reinterpret_cast<const interval*>(COMPLEX(x));
+    const std::uint64_t na = static_cast<std::uint64_t>(interval::IVAL_NA);
+    for (R_xlen_t i=0; i<n; ++i) {
+      if (v[i].isNA()) keys[i] = Key128{na, na};
+    }
+  } else {
+    const period* v = reinterpret_cast<const period*>(COMPLEX(x));
+    const period na(std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::min(), duration::zero());
+    Key128 nakey;
+    memcpy(&nakey, &na, sizeof(nakey));
+    for (R_xlen_t i=0; i<n; ++i) {
+      if (v[i].isNA()) keys[i] = nakey;
+    }
+  }
+  return keys;
+}
+
+
+// Open-addressing table with linear probing, which stores for each
+// distinct key the index of the element that inserted it; the load
+// factor is kept at or under 1/2.
+template <typename K>
+class HashIndex {
+public:
+  HashIndex(const std::vector<K>& keys_p) : keys(keys_p) {
+    size_t sz = 2;
+    while (sz < 2 * keys.size()) sz <<= 1;
+    mask = sz - 1;
+    slots.assign(sz, -1);
+  }
+
+  // the index of the first inserted element equal to 'keys[i]', which
+  // is 'i' itself when 'keys[i]' is new:
+  R_xlen_t insert(R_xlen_t i) {
+    for (size_t h = hashKey(keys[i]) & mask; ; h = (h + 1) & mask) {
+      if (slots[h] < 0) { slots[h] = i; return i; }
+      if (keys[slots[h]] == keys[i]) return slots[h];
+    }
+  }
+
+  // the index of the element equal to 'k', or -1 if there is none:
+  R_xlen_t find(const K& k) const {
+    for (size_t h = hashKey(k) & mask; ; h = (h + 1) & mask) {
+      if (slots[h] < 0 || keys[slots[h]] == k) return slots[h];
+    }
+  }
+
+private:
+  const std::vector<K>& keys;
+  std::vector<R_xlen_t> slots;
+  size_t mask;
+};
+
+
+// 'res[i]' is TRUE if an element equal to element 'i' comes before it,
+// or after it if 'fromLast' is TRUE:
+template <typename K>
+static void duplicatedKeys(const std::vector<K>& keys, bool fromLast, int* res) {
+  HashIndex<K> h(keys);
+  const R_xlen_t n = keys.size();
+  for (R_xlen_t j=0; j<n; ++j) {
+    const R_xlen_t i = fromLast ? n - 1 - j : j;
+    res[i] = h.insert(i) != i;
+  }
+}
+
+template <typename K>
+static void matchKeys(const std::vector<K>& xkeys, const std::vector<K>& tkeys, int nomatch, int* res) {
+  HashIndex<K> h(tkeys);
+  for (R_xlen_t i=0; i<static_cast<R_xlen_t>(tkeys.size()); ++i) h.insert(i);
+  for (R_xlen_t i=0; i<static_cast<R_xlen_t>(xkeys.size()); ++i) {
+    const R_xlen_t j = h.find(xkeys[i]);
+    res[i] = j < 0 ? nomatch : static_cast<int>(j + 1);
+  }
+}
+
+// the index of the first occurrence of each distinct value, in order of
+// appearance, and the number of elements equal to it:
+template <typename K>
+static void tabulateKeys(const std::vector<K>& keys, std::vector<R_xlen_t>& first, std::vector<R_xlen_t>& count) {
+  HashIndex<K> h(keys);
+  std::vector<R_xlen_t> group(keys.size());
+  for (R_xlen_t i=0; i<static_cast<R_xlen_t>(keys.size()); ++i) {
+    const R_xlen_t j = h.insert(i);
+    if (j == i) {
+      group[i] = first.size();
+      first.push_back(i);
+      count.push_back(1);
+    } else {
+      ++count[group[j]];
+    }
+  }
+}
+
+
+// the elements of 'x' at the indices 'idx', keeping the class:
+static SEXP gather(SEXP x, const std::vector<R_xlen_t>& idx) {
+  const R_xlen_t n = idx.size();
+  Rcpp::RObject res = Rf_allocVector(TYPEOF(x), n);
+  if (TYPEOF(x) == CPLXSXP) {
+    const Rcomplex* src = COMPLEX(x);
+    Rcomplex* dst = COMPLEX(res);
+    for (R_xlen_t i=0; i<n; ++i) dst[i] = src[idx[i]];
+  } else {
+    const std::int64_t* src = reinterpret_cast<const std::int64_t*>(REAL(x));
+    std::int64_t* dst = reinterpret_cast<std::int64_t*>(REAL(res));
+    for (R_xlen_t i=0; i<n; ++i) dst[i] = src[idx[i]];
+  }
+  Rf_copyMostAttrib(x, res);
+  return res;
+}
+
+
+// [[Rcpp::export]]
+Rcpp::LogicalVector nano_duplicated_impl(SEXP x, const Rcpp::LogicalVector fromLast_v) {
+  if (fromLast_v.size() != 1 || fromLast_v[0] == NA_LOGICAL) {
+    Rcpp::stop("'fromLast' must be TRUE or FALSE");
+  }
+  const NanoKind kind = getKind(x);
+  Rcpp::LogicalVector res(XLENGTH(x));
+  if (kind == NANOIVAL || kind == NANOPERIOD) {
+    duplicatedKeys(getKeys128(x, kind), fromLast_v[0], res.begin());
+  } else {
+    duplicatedKeys(getKeys64(x), fromLast_v[0], res.begin());
+  }
+  return res;
+}
+
+
+// [[Rcpp::export]]
+SEXP nano_unique_impl(SEXP x, const Rcpp::LogicalVector fromLast_v) {
+  const Rcpp::LogicalVector dup = nano_duplicated_impl(x, fromLast_v);
+  std::vector<R_xlen_t> idx;
+  for (R_xlen_t i=0; i<dup.size(); ++i) {
+    if (!dup[i]) idx.push_back(i);
+  }
+  return gather(x, idx);
+}
+
+
+// [[Rcpp::export]]
+Rcpp::IntegerVector nano_match_impl(SEXP x, SEXP table, const Rcpp::IntegerVector nomatch_v) {
+  const NanoKind kind = getKind(x);
+  if (getKind(table) != kind) {
+    Rcpp::stop("'x' and 'table' must be of the same class");
+  }
+  if (XLENGTH(table) > INT_MAX) {
+    Rcpp::stop("'table' is too long");
+  }
+  if (nomatch_v.size() != 1) {
+    Rcpp::stop("'nomatch' must be an integer scalar");
+  }
+  Rcpp::IntegerVector res(XLENGTH(x));
+  if (kind == NANOIVAL || kind == NANOPERIOD) {
+    matchKeys(getKeys128(x, kind), getKeys128(table, kind), nomatch_v[0], res.begin());
+  } else {
+    matchKeys(getKeys64(x), getKeys64(table), nomatch_v[0], res.begin());
+  }
+  return res;
+}
+
+
+// [[Rcpp::export]]
+Rcpp::List nano_tabulate_impl(SEXP x) {
+  const NanoKind kind = getKind(x);
+  std::vector<R_xlen_t> first, count;
+  if (kind == NANOIVAL || kind == NANOPERIOD) {
+    tabulateKeys(getKeys128(x, kind), first, count);
+  } else {
+    tabulateKeys(getKeys64(x), first, count);
+  }
+  Rcpp::RObject counts;
+  if (XLENGTH(x) > INT_MAX) {
+    Rcpp::NumericVector c(count.begin(), count.end());
+    counts = c;
+  } else {
+    Rcpp::IntegerVector c(count.begin(), count.end());
+    counts = c;
+  }
+  return Rcpp::List::create(Rcpp::Named("x")     = gather(x, first),
+                            Rcpp::Named("count") = counts);
+}
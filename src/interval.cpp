@@ -1,9 +1,16 @@
+#include <climits>
 #include <iostream>
 #include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
 #include <Rcpp.h>
+#include <Rversion.h>
 #include <RcppCCTZ_API.h>
 #include "nanotime/interval.hpp"
+#include "nanotime/parallel.hpp"
 #include "nanotime/pseudovector.hpp"
+#include "nanotime/radix.hpp"
 #include "nanotime/utilities.hpp"
 #include "cctz/civil_time.h"
 #include "cctz/time_zone.h"
@@ -36,6 +43,31 @@ typedef ConstPseudoVector<LGLSXP,  int>      ConstPseudoVectorLgl;
 typedef ConstPseudoVector<STRSXP,  const Rcpp::CharacterVector::const_Proxy> ConstPseudoVectorChar;
 
 
+// Results whose length is only known once they are computed are written in place into an R
+// vector allocated for an upper bound of that length and then shrunk, rather than built in a
+// 'std::vector' and copied, which needs twice the memory at the peak plus the reallocations of
+// the 'std::vector'. With R >= 4.6 the vector is resizable and shrinking it costs nothing, but
+// it keeps its capacity, so a result that is much shorter than the bound is copied out, as it
+// always is before R 4.6:
+static SEXP allocShrinkable(SEXPTYPE type, R_xlen_t maxlen) {
+#if R_VERSION >= R_Version(4, 6, 0)
+  return R_allocResizableVector(type, maxlen);
+#else
+  return Rf_allocVector(type, maxlen);
+#endif
+}
+
+static SEXP shrinkVector(SEXP x, R_xlen_t len) {
+#if R_VERSION >= R_Version(4, 6, 0)
+  if (len >= XLENGTH(x) / 2) {
+    R_resizeVector(x, len);
+    return x;
+  }
+#endif
+  return XLENGTH(x) == len ? x : Rf_xlengthgets(x, len);
+}
+
+
 // for debug reasons...
 // cf https://stackoverflow.com/a/16692519
 template<typename Clock, typename Duration>
@@ -51,22 +83,119 @@ static void print(const interval& i) {
 }
 #endif
 
+
+// When one side of a time/interval merge is much larger than the other, it is cheaper to skip
+// whole runs of the larger side with an exponential search followed by a binary search than
+// to step through it one element at a time. Above this size ratio we switch to galloping:
+static const size_t GALLOP_RATIO = 16;
+
+
+/// Return the first index in '[i, n)' for which 'pred' is false; 'pred' must be true on a
+/// prefix of the range and false on the rest of it. The cost is logarithmic in the distance
+/// between 'i' and the result rather than linear.
+template <typename I, typename PRED>
+static I gallop(I i, I n, PRED pred) {
+  if (i >= n || !pred(i)) return i;
+  I lo = i + 1, hi = i + 1, bound = 1;
+  while (hi < n && pred(hi)) {
+    lo = hi + 1;
+    bound *= 2;
+    hi = i + bound;
+  }
+  if (hi > n) hi = n;
+  while (lo < hi) {
+    const I mid = lo + (hi - lo) / 2;
+    if (pred(mid)) lo = mid + 1; else hi = mid;
+  }
+  return lo;
+}
+
+
+/// Which side of a time/interval merge to gallop over. The sorted times can always be
+/// galloped over, but the intervals, which are sorted on their start, only where their ends
+/// are sorted too, which makes 't > v[i]' monotone in 'i'. Rather than checking that on all
+/// the intervals beforehand, it is checked on the ranges that are galloped over, up to index
+/// 'checked', and galloping over the intervals is given up the first time it does not hold.
+struct GallopMode {
+  bool times;
+  bool intervals;
+  size_t checked;
+};
+
+static GallopMode selectGallop(size_t v1_size, size_t v2_size) {
+  GallopMode res { false, false, 0 };
+  if (v1_size / GALLOP_RATIO > v2_size) {
+    res.times = true;
+  } else if (v2_size / GALLOP_RATIO > v1_size) {
+    res.intervals = true;
+  }
+  return res;
+}
+
+
+/// Return the index of the first time in 'v1' from 'i1' that is not before 'ival'.
+template <typename I>
+static inline I skip_times_before(const dtime* v1, I i1, I v1_size, const interval& ival, bool gallop_p) {
+  if (!gallop_p) return i1 + 1;
+  return gallop(i1, v1_size, [v1, &ival](I k) { return v1[k] < ival; });
+}
+
+
+/// Return the index of the first time in 'v1' from 'i1' that is after 'ival'.
+template <typename I>
+static inline I skip_times_in(const dtime* v1, I i1, I v1_size, const interval& ival, bool gallop_p) {
+  if (!gallop_p) return i1 + 1;
+  return gallop(i1, v1_size, [v1, &ival](I k) { return !(v1[k] > ival); });
+}
+
+
+/// Return the index of the first interval in 'v2' from 'i2' that does not end before 't'.
+template <typename I>
+static inline I skip_intervals_before(const interval* v2, I i2, I v2_size, const dtime& t, GallopMode& mode) {
+  if (!mode.intervals) return i2 + 1;
+  const I r = gallop(i2, v2_size, [v2, &t](I k) { return t > v2[k]; });
+  // 't' is after 'v2[r-1]', and so after all the intervals skipped if their ends are sorted:
+  for (I k=std::max(static_cast<I>(mode.checked), i2 + 1); k < r; ++k) {
+    if (end_gt(v2[k-1], v2[k])) {
+      mode.intervals = false;
+      return i2 + 1;
+    }
+  }
+  mode.checked = std::max(mode.checked, static_cast<size_t>(r));
+  return r;
+}
+
+// 'NA' is the smallest 'integer64', so it comes first in sorted times, but 'sort' puts it
+// last by default: the merges of sorted times stop at their trailing 'NA', which match
+// nothing, and only the times before that must be in order.
+static R_xlen_t withoutTrailingNA(SEXP nv) {
+  const std::int64_t* v = readOnly<std::int64_t>(nv);
+  R_xlen_t n = XLENGTH(nv);
+  while (n > 0 && v[n-1] == NA_INTEGER64) --n;
+  return n;
+}
+
 template <typename T, typename U>
 static Rcpp::List intersect_idx(const T* v1, size_t v1_size, const U* v2, size_t v2_size) 
 {
-  // because 'push_back' on R structures is crazy expensive, we use STL vector and copy afterwards:
-  std::vector<double> res_first;
-  std::vector<double> res_second;
+  // each time is matched at most once, so 'v1_size' bounds the length of the result:
+  Rcpp::NumericVector res_first(allocShrinkable(REALSXP, v1_size));
+  Rcpp::NumericVector res_second(allocShrinkable(REALSXP, v1_size));
+  double* pfirst  = res_first.begin();
+  double* psecond = res_second.begin();
+  size_t len = 0;
+  auto mode = selectGallop(v1_size, v2_size);
   size_t i1 = 0, i2 = 0;
   while (i1 < v1_size && i2 < v2_size) {
     if (v1[i1] < v2[i2]) {
-      ++i1;
+      i1 = skip_times_before(v1, i1, v1_size, v2[i2], mode.times);
     } else if (v1[i1] > v2[i2]) {
-      ++i2;
+      i2 = skip_intervals_before(v2, i2, v2_size, v1[i1], mode);
     } else { 
       if (v1_size==0 || v1[i1] != v1[i1-1]) {
-        res_first.push_back(i1+1);
-        res_second.push_back(i2+1);
+        pfirst[len]  = i1+1;
+        psecond[len] = i2+1;
+        ++len;
       }      
       ++i1;
       //++i2; this is correct for T==U, but not for example when
@@ -74,14 +203,10 @@ static Rcpp::List intersect_idx(const T* v1, size_t v1_size, const U* v2, size_t
     }
   }
 
-  // copy out result:
-  Rcpp::NumericVector res_first_rcpp(res_first.size());
-  Rcpp::NumericVector res_second_rcpp(res_second.size());
-  if (res_first.size() > 0) memcpy(&res_first_rcpp[0],  &res_first[0],  sizeof(double)*res_first.size());
-  if (res_second.size() > 0) memcpy(&res_second_rcpp[0], &res_second[0], sizeof(double)*res_second.size());
-  
-  return Rcpp::List::create(Rcpp::Named("x") = res_first_rcpp,
-                            Rcpp::Named("y") = res_second_rcpp);
+  const Rcpp::NumericVector x(shrinkVector(res_first, len));
+  const Rcpp::NumericVector y(shrinkVector(res_second, len));
+  return Rcpp::List::create(Rcpp::Named("x") = x,
+                            Rcpp::Named("y") = y);
 }
 
 
@@ -89,16 +214,16 @@ static Rcpp::List intersect_idx(const T* v1, size_t v1_size, const U* v2, size_t
 // return the result as boolean; this is useful for `data.table`
 // subsetting:
 template <typename T, typename U>
-static std::vector<int> intersect_idx_logical(const T* v1, size_t v1_size, const U* v2, size_t v2_size) 
+static void intersect_idx_logical(const T* v1, size_t v1_size, const U* v2, size_t v2_size,
+                                  int* res)     // 'v1_size' elements, all 'FALSE'
 {
-  std::vector<int> res(v1_size);
+  auto mode = selectGallop(v1_size, v2_size);
   size_t i1 = 0, i2 = 0;
   while (i1 < v1_size && i2 < v2_size) {
     if (v1[i1] < v2[i2]) {
-      res[i1] = FALSE;
-      ++i1;
+      i1 = skip_times_before(v1, i1, v1_size, v2[i2], mode.times);
     } else if (v1[i1] > v2[i2]) {
-      ++i2;
+      i2 = skip_intervals_before(v2, i2, v2_size, v1[i1], mode);
     } else { 
       if (v1_size==0 || v1[i1] != v1[i1-1]) {
         res[i1] = TRUE;
@@ -106,7 +231,6 @@ static std::vector<int> intersect_idx_logical(const T* v1, size_t v1_size, const
       ++i1;
     }
   }
-  return res;
 }
 
 
@@ -127,39 +251,264 @@ static std::vector<int> intersect_idx_logical(const T* v1, size_t v1_size, const
 
 
 // [[Rcpp::export]]
-Rcpp::List nanoival_intersect_idx_time_interval_impl(const Rcpp::NumericVector nv1,
-                                                     const Rcpp::ComplexVector nv2) {
-  const dtime* v1 = reinterpret_cast<const dtime*>(&nv1[0]);
-  const interval*      v2 = reinterpret_cast<const interval*>(&nv2[0]);
-  return intersect_idx(v1, nv1.size(), v2, nv2.size());
+Rcpp::List nanoival_intersect_idx_time_interval_impl(SEXP nv1,
+                                                     SEXP nv2) {
+  const dtime* v1 = readOnly<dtime>(nv1);
+  const interval*      v2 = readOnly<interval>(nv2);
+  return intersect_idx(v1, withoutTrailingNA(nv1), v2, XLENGTH(nv2));
 }
 
 
 // [[Rcpp::export]]
-Rcpp::LogicalVector nanoival_intersect_idx_time_interval_logical_impl(const Rcpp::NumericVector nv1,
-                                                             const Rcpp::ComplexVector nv2) {
-  const dtime* v1 = reinterpret_cast<const dtime*>(&nv1[0]);
-  const interval*      v2 = reinterpret_cast<const interval*>(&nv2[0]);
-  auto res_c = intersect_idx_logical(v1, nv1.size(), v2, nv2.size());
-  Rcpp::LogicalVector res(nv1.size());
-  if (nv1.size() > 0) memcpy(&res[0], &res_c[0], sizeof(int)*nv1.size());
+Rcpp::LogicalVector nanoival_intersect_idx_time_interval_logical_impl(SEXP nv1,
+                                                             SEXP nv2) {
+  const dtime* v1 = readOnly<dtime>(nv1);
+  const interval*      v2 = readOnly<interval>(nv2);
+  Rcpp::LogicalVector res(XLENGTH(nv1));
+  intersect_idx_logical(v1, withoutTrailingNA(nv1), v2, XLENGTH(nv2), res.begin());
   return res;
 }
 
 
+// Count, for each interval of 'nv2', the times of the sorted 'nv1' that it contains, and
+// optionally the first and the last of them, without materialising the matching pairs. The
+// bounds of each interval in 'nv1' are found by galloping from those of the previous
+// interval when that one starts (ends) no later, so that sorted intervals make this a single
+// merge, while intervals in any order are still counted correctly. 'NA' intervals get an
+// 'NA' count.
+// [[Rcpp::export]]
+SEXP nanoival_intersect_count_impl(SEXP                      nv1,
+                                   SEXP                      nv2,
+                                   const Rcpp::LogicalVector bounds_v) {
+  if (bounds_v.size() != 1 || bounds_v[0] == NA_LOGICAL) Rcpp::stop("'bounds' must be a non-NA logical scalar");
+  const dtime* v1 = readOnly<dtime>(nv1);
+  const interval* v2 = readOnly<interval>(nv2);
+  const R_xlen_t n1 = withoutTrailingNA(nv1), n2 = XLENGTH(nv2);
+
+  // '[lo, hi)' is the range of 'nv1' in each interval, 'lo' being -1 for an 'NA' interval:
+  std::vector<R_xlen_t> lo(n2), hi(n2);
+  parallel_for(n2, [&](R_xlen_t begin, R_xlen_t end) {
+    R_xlen_t p = -1;            // previous non-empty interval of this chunk
+    for (R_xlen_t j=begin; j<end; ++j) {
+      const interval& ival = v2[j];
+      if (ival.isNA()) {
+        lo[j] = -1;
+        continue;
+      }
+      // an empty interval contains no time, and its bounds would not be valid starting
+      // points for the next interval:
+      if (is_empty(ival)) {
+        lo[j] = hi[j] = 0;
+        continue;
+      }
+      const bool from_lo = p >= 0 && start_key(v2[p]) <= start_key(ival);
+      const bool from_hi = p >= 0 && end_key(v2[p]) <= end_key(ival);
+      lo[j] = gallop(from_lo ? lo[p] : R_xlen_t(0), n1, [v1, &ival](R_xlen_t k) { return v1[k] < ival; });
+      hi[j] = gallop(from_hi ? std::max(hi[p], lo[j]) : lo[j], n1, [v1, &ival](R_xlen_t k) { return !(v1[k] > ival); });
+      p = j;
+    }
+  });
+
+  // the counts are integers unless 'nv1' is too long for them to fit:
+  Rcpp::RObject count;
+  if (n1 > INT_MAX) {
+    Rcpp::NumericVector c(n2);
+    for (R_xlen_t j=0; j<n2; ++j) c[j] = lo[j] < 0 ? NA_REAL : hi[j] - lo[j];
+    count = c;
+  } else {
+    Rcpp::IntegerVector c(n2);
+    for (R_xlen_t j=0; j<n2; ++j) c[j] = lo[j] < 0 ? NA_INTEGER : hi[j] - lo[j];
+    count = c;
+  }
+  if (!bounds_v[0]) {
+    return count;
+  }
+
+  Rcpp::NumericVector first(n2), last(n2);
+  for (R_xlen_t j=0; j<n2; ++j) {
+    const bool none = lo[j] < 0 || hi[j] == lo[j];
+    first[j] = none ? NA_REAL : lo[j] + 1;
+    last[j]  = none ? NA_REAL : hi[j];
+  }
+  return Rcpp::List::create(Rcpp::Named("count") = count,
+                            Rcpp::Named("first") = first,
+                            Rcpp::Named("last")  = last);
+}
+
+
+// As-of join between two sorted 'nanotime' vectors: for each element of 'x', the index of the
+// last element of 'y' at or before it ('backward'), of the first at or after it ('forward'),
+// or of the closer of the two ('nearest', 'backward' on ties), provided the distance does not
+// exceed the tolerance. Both cursors only move forward, so this is a single merge; when split
+// across threads, each chunk of 'x' seeds its cursors with a binary search in 'y'.
+enum class AsofRoll { BACKWARD, FORWARD, NEAREST };
+
+// [[Rcpp::export]]
+Rcpp::NumericVector nanotime_asof_idx_impl(SEXP                      nv1,        // sorted 'nanotime'
+                                           SEXP                      nv2,        // sorted 'nanotime'
+                                           const Rcpp::CharacterVector roll_v,   // "backward", "forward" or "nearest"
+                                           const Rcpp::NumericVector tol_v) {    // empty or scalar 'nanoduration'
+  if (roll_v.size() != 1) Rcpp::stop("'roll' must be scalar");
+  const auto roll_s = Rcpp::as<std::string>(roll_v[0]);
+  AsofRoll roll;
+  if      (roll_s == "backward") roll = AsofRoll::BACKWARD;
+  else if (roll_s == "forward")  roll = AsofRoll::FORWARD;
+  else if (roll_s == "nearest")  roll = AsofRoll::NEAREST;
+  else Rcpp::stop("unknown 'roll' value '" + roll_s + "'");
+
+  // the distances are computed on unsigned integers so that they cannot overflow:
+  std::uint64_t tol = std::numeric_limits<std::uint64_t>::max();
+  if (tol_v.size() > 1) Rcpp::stop("'tolerance' must be scalar");
+  if (tol_v.size() == 1) {
+    std::int64_t t; memcpy(&t, reinterpret_cast<const char*>(&tol_v[0]), sizeof(t));
+    if (t == NA_INTEGER64 || t < 0) Rcpp::stop("'tolerance' must be a non-negative duration");
+    tol = t;
+  }
+
+  const std::int64_t* v1 = readOnly<std::int64_t>(nv1);
+  const std::int64_t* v2 = readOnly<std::int64_t>(nv2);
+  const R_xlen_t n1 = XLENGTH(nv1);
+  // the 'NA' elements of 'y' come first or last:
+  const std::int64_t* y1 = v2 + withoutTrailingNA(nv2);
+  const std::int64_t* y0 = std::upper_bound(v2, y1, NA_INTEGER64);
+  auto dist = [](std::int64_t a, std::int64_t b) {
+    return static_cast<std::uint64_t>(a) - static_cast<std::uint64_t>(b);
+  };
+
+  Rcpp::NumericVector res(n1);
+  double* pres = res.begin();
+  parallel_for(n1, [&](R_xlen_t begin, R_xlen_t end) {
+    if (begin >= end) return;
+    auto up = std::upper_bound(y0, y1, v1[begin]);    // first 'y' after 'x'
+    auto lo = std::lower_bound(y0, y1, v1[begin]);    // first 'y' at or after 'x'
+    for (R_xlen_t i=begin; i<end; ++i) {
+      const auto x = v1[i];
+      pres[i] = NA_REAL;
+      if (x == NA_INTEGER64) continue;
+      while (up < y1 && *up <= x) ++up;
+      while (lo < y1 && *lo <  x) ++lo;
+      const bool has_b = up > y0 && dist(x, *(up - 1)) <= tol;
+      const bool has_f = lo < y1 && dist(*lo, x) <= tol;
+      const std::int64_t* m = nullptr;
+      switch (roll) {
+      case AsofRoll::BACKWARD: if (has_b) m = up - 1; break;
+      case AsofRoll::FORWARD:  if (has_f) m = lo;     break;
+      case AsofRoll::NEAREST:
+        if (has_b && has_f) m = dist(x, *(up - 1)) <= dist(*lo, x) ? up - 1 : lo;
+        else if (has_b)     m = up - 1;
+        else if (has_f)     m = lo;
+        break;
+      }
+      if (m) pres[i] = static_cast<double>(m - v2 + 1);
+    }
+  });
+  return res;
+}
+
+
+// Overlap join: all the pairs of overlapping intervals between two 'nanoival' vectors, which
+// need be neither sorted nor free of overlaps. This is a sweep on the interval starts: each
+// interval, when reached, is matched against the intervals of the other vector that are
+// still open, and the ones that ended before its start are dropped on the way, so that each
+// scanned element is either a match or is dropped. Empty and 'NA' intervals never match.
+static std::vector<R_xlen_t> sortedOnStart(const interval* v, R_xlen_t n, std::vector<std::int64_t>& sk) {
+  std::vector<R_xlen_t> order;
+  sk.resize(n);
+  for (R_xlen_t i=0; i<n; ++i) {
+    sk[i] = start_key(v[i]);
+    if (!v[i].isNA() && !is_empty(v[i])) order.push_back(i);
+  }
+  std::stable_sort(order.begin(), order.end(), [&sk](R_xlen_t a, R_xlen_t b) { return sk[a] < sk[b]; });
+  return order;
+}
+
 // [[Rcpp::export]]
-Rcpp::S4 nanoival_intersect_time_interval_impl(const Rcpp::NumericVector nv1,
-                                               const Rcpp::ComplexVector nv2) {
+Rcpp::List nanoival_overlap_idx_impl(SEXP                      cv1,
+                                     SEXP                      cv2,
+                                     const Rcpp::LogicalVector intersection_v) {
+  if (intersection_v.size() != 1 || intersection_v[0] == NA_LOGICAL) {
+    Rcpp::stop("'intersection' must be a non-NA logical scalar");
+  }
+  const interval* v1 = readOnly<interval>(cv1);
+  const interval* v2 = readOnly<interval>(cv2);
+  std::vector<std::int64_t> sk1, sk2;
+  const auto order1 = sortedOnStart(v1, XLENGTH(cv1), sk1);
+  const auto order2 = sortedOnStart(v2, XLENGTH(cv2), sk2);
+
+  std::vector<std::pair<R_xlen_t, R_xlen_t>> pairs;
+  std::vector<R_xlen_t> active1, active2;
+  // match the interval 'i' starting at 'start' against the open intervals of 'active':
+  auto sweep = [&pairs](std::vector<R_xlen_t>& active, const interval* v, std::int64_t start, R_xlen_t i, bool first) {
+    for (size_t k=0; k<active.size(); ) {
+      if (end_key(v[active[k]]) < start) {
+        active[k] = active.back();
+        active.pop_back();
+      } else {
+        pairs.push_back(first ? std::make_pair(i, active[k]) : std::make_pair(active[k], i));
+        ++k;
+      }
+    }
+  };
+
+  size_t i1 = 0, i2 = 0;
+  while (i1 < order1.size() || i2 < order2.size()) {
+    if (i2 == order2.size() || (i1 < order1.size() && sk1[order1[i1]] <= sk2[order2[i2]])) {
+      const auto i = order1[i1++];
+      sweep(active2, v2, sk1[i], i, true);
+      active1.push_back(i);
+    } else {
+      const auto i = order2[i2++];
+      sweep(active1, v1, sk2[i], i, false);
+      active2.push_back(i);
+    }
+  }
+  std::sort(pairs.begin(), pairs.end());
+
+  Rcpp::NumericVector res_x(pairs.size()), res_y(pairs.size());
+  for (size_t k=0; k<pairs.size(); ++k) {
+    res_x[k] = pairs[k].first + 1;
+    res_y[k] = pairs[k].second + 1;
+  }
+  if (!intersection_v[0]) {
+    return Rcpp::List::create(Rcpp::Named("x") = res_x,
+                              Rcpp::Named("y") = res_y);
+  }
+
+  // the intersection takes the greater start and the smaller end, the keys already
+  // accounting for whether they are open:
+  Rcpp::ComplexVector res_i(pairs.size());
+  for (size_t k=0; k<pairs.size(); ++k) {
+    const interval& a = v1[pairs[k].first];
+    const interval& b = v2[pairs[k].second];
+    const bool sa = start_key(a) >= start_key(b);
+    const bool ea = end_key(a) <= end_key(b);
+    const interval ival(sa ? a.getStart() : b.getStart(),
+                        ea ? a.getEnd()   : b.getEnd(),
+                        sa ? a.sopen()    : b.sopen(),
+                        ea ? a.eopen()    : b.eopen());
+    memcpy(&res_i[k], &ival, sizeof(ival));
+  }
+  return Rcpp::List::create(Rcpp::Named("x") = res_x,
+                            Rcpp::Named("y") = res_y,
+                            Rcpp::Named("intersection") = assignS4("nanoival", res_i));
+}
+
+
+// [[Rcpp::export]]
+Rcpp::S4 nanoival_intersect_time_interval_impl(SEXP nv1,
+                                               SEXP nv2) {
   std::vector<dtime> res;
-  const dtime* v1 = reinterpret_cast<const dtime*>(&nv1[0]);
-  const interval* v2 = reinterpret_cast<const interval*>(&nv2[0]);
+  const dtime* v1 = readOnly<dtime>(nv1);
+  const interval* v2 = readOnly<interval>(nv2);
 
+  const R_xlen_t v1_size = withoutTrailingNA(nv1), v2_size = XLENGTH(nv2);
+  auto mode = selectGallop(v1_size, v2_size);
   R_xlen_t i1 = 0, i2 = 0;
-  while (i1 < nv1.size() && i2 < nv2.size()) {
+  while (i1 < v1_size && i2 < v2_size) {
     if (v1[i1] < v2[i2]) {
-      ++i1;
+      i1 = skip_times_before(v1, i1, v1_size, v2[i2], mode.times);
     } else if (v1[i1] > v2[i2]) {
-      ++i2;
+      i2 = skip_intervals_before(v2, i2, v2_size, v1[i1], mode);
     } else {
       if (res.size()==0 || v1[i1] != res.back()) {
         res.push_back(v1[i1]);
@@ -180,42 +529,154 @@ Rcpp::S4 nanoival_intersect_time_interval_impl(const Rcpp::NumericVector nv1,
 }
 
 // [[Rcpp::export]]
-Rcpp::NumericVector nanoival_setdiff_time_interval_impl(const Rcpp::NumericVector nv1,
-                                                        const Rcpp::ComplexVector nv2) {
+Rcpp::NumericVector nanoival_setdiff_time_interval_impl(SEXP nv1,
+                                                        SEXP nv2) {
   std::vector<dtime> res;
-  const dtime* v1 = reinterpret_cast<const dtime*>(&nv1[0]);
-  const interval* v2 = reinterpret_cast<const interval*>(&nv2[0]);
+  const dtime* v1 = readOnly<dtime>(nv1);
+  const interval* v2 = readOnly<interval>(nv2);
 
+  const R_xlen_t v1_size = withoutTrailingNA(nv1), v2_size = XLENGTH(nv2);
+  auto mode = selectGallop(v1_size, v2_size);
   R_xlen_t i1 = 0, i2 = 0;
-  while (i1 < nv1.size() && i2 < nv2.size()) {
+  while (i1 < v1_size && i2 < v2_size) {
     if (v1[i1] < v2[i2]) {
-      res.push_back(v1[i1++]);
+      const auto next = skip_times_before(v1, i1, v1_size, v2[i2], mode.times);
+      res.insert(res.end(), v1 + i1, v1 + next);
+      i1 = next;
     } else if (v1[i1] > v2[i2]) {
-      ++i2;
+      i2 = skip_intervals_before(v2, i2, v2_size, v1[i1], mode);
     } else {
-      ++i1;
+      i1 = skip_times_in(v1, i1, v1_size, v2[i2], mode.times);
     }
   }
-  // pick up elts left in v1:
-  while (i1 < nv1.size()) {
-    res.push_back(v1[i1++]);
-  }
+  // pick up elts left in v1, trailing 'NA' included:
+  res.insert(res.end(), v1 + i1, v1 + XLENGTH(nv1));
   
   double* res_start = reinterpret_cast<double*>(&res[0]);
   double* res_end   = res_start + res.size();
   return Rcpp::NumericVector(res_start, res_end);
 }
 
-// [[Rcpp::export]]
-Rcpp::ComplexVector nanoival_union_impl(const Rcpp::ComplexVector nv1,
-                                        const Rcpp::ComplexVector nv2) {
-  // assume 'nanoival1/2' were sorted at the R level
-  std::vector<interval> res;
-  const interval* v1 = reinterpret_cast<const interval*>(&nv1[0]);
-  const interval* v2 = reinterpret_cast<const interval*>(&nv2[0]);
+// Set operations on two sorted 'nanoival' vectors. Each of the merges below is written for a
+// co-range '[b1, e1)' x '[b2, e2)' of its two inputs so that it can be split across threads.
+// The co-ranges are cut only at points where every interval before the cut, in both inputs,
+// ends strictly before any interval after the cut starts: at such a point the serial merge
+// carries no state over, so each co-range produces exactly the output the serial merge
+// produces while consuming it, and the results are simply concatenated. In order to match
+// the serial merge step for step, a merge may look at the first elements past its co-range
+// ('v1[e1]' or 'v2[e2]'), but never produces output for them.
+
+struct MergeRange {
+  R_xlen_t b1, e1;              // co-range of the first input
+  R_xlen_t b2, e2;              // co-range of the second input
+};
 
-  R_xlen_t i1 = 0, i2 = 0;
-  if (nv1.size() > 0 && nv2.size() > 0) {
+
+/// Find the co-ranges in which to split the merge of 'v1' and 'v2', one per thread. Candidate
+/// cuts are placed at even distances along the merge path (the merge of the two inputs on
+/// the interval starts) and are then moved forward along it until no interval straddles the
+/// cut; a candidate for which no such point is found before the next one is dropped, so that
+/// heavily overlapping inputs degrade to the serial merge.
+static std::vector<MergeRange> mergeRanges(const interval* v1, R_xlen_t n1, const interval* v2, R_xlen_t n2) {
+  std::vector<MergeRange> res;
+  const R_xlen_t n = n1 + n2;
+  const R_xlen_t nchunks = std::min(static_cast<R_xlen_t>(getThreads()), n / PARALLEL_MIN_CHUNK);
+  if (nchunks <= 1 || n1 == 0 || n2 == 0) {
+    res.push_back(MergeRange{ 0, n1, 0, n2 });
+    return res;
+  }
+
+  // running maximum of the interval ends, 'emax[i]' being the maximum over '[0, i)':
+  auto prefixMaxEnd = [](const interval* v, R_xlen_t len) {
+    std::vector<std::int64_t> emax(len + 1);
+    emax[0] = std::numeric_limits<std::int64_t>::min();
+    for (R_xlen_t i=0; i<len; ++i) {
+      emax[i+1] = std::max(emax[i], v[i].e());
+    }
+    return emax;
+  };
+  const auto emax1 = prefixMaxEnd(v1, n1);
+  const auto emax2 = prefixMaxEnd(v2, n2);
+
+  R_xlen_t p1 = 0, p2 = 0;      // end of the previous co-range
+  for (R_xlen_t k=1; k<nchunks; ++k) {
+    const R_xlen_t d     = k * n / nchunks;
+    const R_xlen_t dnext = (k + 1) * n / nchunks;
+    if (d <= p1 + p2) continue;
+
+    // split the first 'd' elements of the merge path between the two inputs:
+    R_xlen_t lo = std::max(R_xlen_t(0), d - n2), hi = std::min(d, n1);
+    while (lo < hi) {
+      const R_xlen_t mid = lo + (hi - lo) / 2;
+      if (v1[mid].s() <= v2[d - mid - 1].s()) lo = mid + 1; else hi = mid;
+    }
+    R_xlen_t a1 = lo, a2 = d - lo;
+
+    // move forward along the merge path until nothing straddles the cut:
+    bool found = false;
+    while (a1 < n1 && a2 < n2 && a1 + a2 < dnext) {
+      if (std::max(emax1[a1], emax2[a2]) < std::min(v1[a1].s(), v2[a2].s())) {
+        found = true;
+        break;
+      }
+      if (v1[a1].s() <= v2[a2].s()) ++a1; else ++a2;
+    }
+    if (found) {
+      res.push_back(MergeRange{ p1, a1, p2, a2 });
+      p1 = a1;
+      p2 = a2;
+    }
+  }
+  res.push_back(MergeRange{ p1, n1, p2, n2 });
+  return res;
+}
+
+
+/// Where a merge writes its intervals: directly into the memory of the R vector returned.
+struct IntervalSink {
+  interval* p;
+  size_t n;
+  void push_back(const interval& i) { p[n++] = i; }
+};
+
+
+/// Run 'merge' on each co-range of 'nv1' and 'nv2', in parallel when there is more than one,
+/// and concatenate the results.
+template <typename MERGE>
+static Rcpp::ComplexVector mergeIntervals(SEXP nv1,
+                                          SEXP nv2,
+                                          MERGE merge) {
+  const interval* v1 = readOnly<interval>(nv1);
+  const interval* v2 = readOnly<interval>(nv2);
+  const R_xlen_t n1 = XLENGTH(nv1), n2 = XLENGTH(nv2);
+
+  // a co-range gives at most as many intervals as it has inputs, so each one writes its
+  // result at the offset 'b1 + b2' of a vector of 'n1 + n2' intervals; the results are then
+  // moved down to be contiguous:
+  const auto ranges = mergeRanges(v1, n1, v2, n2);
+  Rcpp::ComplexVector finalres(allocShrinkable(CPLXSXP, n1 + n2));
+  interval* out = reinterpret_cast<interval*>(finalres.begin());
+  std::vector<size_t> lens(ranges.size());
+  parallel_tasks(ranges.size(), [&](R_xlen_t k) {
+    IntervalSink sink { out + ranges[k].b1 + ranges[k].b2, 0 };
+    merge(v1, n1, v2, n2, ranges[k], sink);
+    lens[k] = sink.n;
+  });
+
+  size_t len = 0;
+  for (size_t k=0; k<ranges.size(); ++k) {
+    const interval* part = out + ranges[k].b1 + ranges[k].b2;
+    if (part != out + len && lens[k] > 0) memmove(out + len, part, sizeof(interval)*lens[k]);
+    len += lens[k];
+  }
+  return shrinkVector(finalres, len);
+}
+
+
+static void union_range(const interval* v1, R_xlen_t n1, const interval* v2, R_xlen_t n2,
+                        const MergeRange& r, IntervalSink& res) {
+  R_xlen_t i1 = r.b1, i2 = r.b2;
+  if (i1 < n1 && i2 < n2) {
     auto v1_lt_v2 = start_lt(v1[i1], v2[i2]);
     auto start = v1_lt_v2 ? v1[i1].getStart() : v2[i2].getStart();
     auto sopen = v1_lt_v2 ? v1[i1].sopen() : v2[i2].sopen();
@@ -224,7 +685,7 @@ Rcpp::ComplexVector nanoival_union_impl(const Rcpp::ComplexVector nv1,
       if (union_end_ge_start(v1[i1], v2[i2]) && union_end_le(v1[i1], v2[i2])) {
         // v1 |------------|         or     |--------|
         // v2      |------------|         |------------|
-        if (i1 >= nv1.size() - 1) {
+        if (i1 >= n1 - 1) {
           // if equal ends, have to do the union of the eopens:
           auto eopen = union_end_le(v2[i2], v1[i1]) ? v1[i1].eopen() && v2[i2].eopen() : v2[i2].eopen();
           // v2 interval done, as there's no more v1 elts to overlap
@@ -236,7 +697,7 @@ Rcpp::ComplexVector nanoival_union_impl(const Rcpp::ComplexVector nv1,
       } else if (union_end_ge_start(v2[i2], v1[i1]) && union_end_le(v2[i2], v1[i1])) {
         // v1      |------------|   or    |------------|
         // v2 |------------|                |--------|
-        if (i2 >= nv2.size() - 1) {
+        if (i2 >= n2 - 1) {
           // if equal ends, have to do the union of the eopens:
           auto eopen = union_end_le(v1[i1], v2[i2]) ? v1[i1].eopen() && v2[i2].eopen() : v1[i1].eopen();
           // v1 interval done, as there's no more v2 elts to overlap
@@ -259,8 +720,8 @@ Rcpp::ComplexVector nanoival_union_impl(const Rcpp::ComplexVector nv1,
           res.push_back(interval(start, v2[i2].getEnd(), sopen, v2[i2].eopen()));
           ++i2;
         }
-        // set the start of the next interval:
-        if (i1 < nv1.size() && i2 < nv2.size()) {
+        // set the start of the next interval, unless the co-range is done:
+        if (i1 < n1 && i2 < n2 && (i1 < r.e1 || i2 < r.e2)) {
           auto v1_lt_v2 = start_lt(v1[i1], v2[i2]);
           start = v1_lt_v2 ? v1[i1].getStart() : v2[i2].getStart();
           sopen = v1_lt_v2 ? v1[i1].sopen() : v2[i2].sopen();
@@ -271,29 +732,209 @@ Rcpp::ComplexVector nanoival_union_impl(const Rcpp::ComplexVector nv1,
     }
   }
   // remaining non-overlapping intervals in v1:
-  while (i1 < nv1.size()) {
+  while (i1 < r.e1) {
     res.push_back(v1[i1++]);
   }
-  while (i2 < nv2.size()) {
+  while (i2 < r.e2) {
     res.push_back(v2[i2++]);
   }
+}
+
+// [[Rcpp::export]]
+Rcpp::ComplexVector nanoival_union_impl(SEXP nv1,
+                                        SEXP nv2) {
+  // assume 'nanoival1/2' were sorted at the R level
+  return mergeIntervals(nv1, nv2, union_range);
+}
+
+
+// Coalesce a single 'nanoival' vector into sorted, disjoint intervals: intervals that overlap
+// or touch, following the semantic of 'union_end_ge_start', are merged in one pass over the
+// vector in sorted order. 'NA' and empty intervals are dropped. If 'mapping' is true, the
+// 1-based position in the result of the interval that absorbed each input is also returned,
+// 'NA' for the dropped ones.
+// [[Rcpp::export]]
+SEXP nanoival_reduce_impl(SEXP cv,
+                          const Rcpp::LogicalVector sorted_v,
+                          const Rcpp::LogicalVector mapping_v) {
+  if (sorted_v.size() != 1 || sorted_v[0] == NA_LOGICAL) Rcpp::stop("'sorted' must be a non-NA logical scalar");
+  if (mapping_v.size() != 1 || mapping_v[0] == NA_LOGICAL) Rcpp::stop("'mapping' must be a non-NA logical scalar");
+
+  const interval* v = readOnly<interval>(cv);
+  const R_xlen_t n = XLENGTH(cv);
+  std::vector<R_xlen_t> order;
+  if (sorted_v[0]) {
+    order.resize(n);
+    std::iota(order.begin(), order.end(), 0);
+  } else {
+    order = radix_order(v, n, false);
+  }
+
+  std::vector<interval> res;
+  Rcpp::NumericVector map(mapping_v[0] ? n : 0, NA_REAL);
+  R_xlen_t k = 0;
+  while (k < n && (v[order[k]].isNA() || is_empty(v[order[k]]))) ++k;
+  if (k < n) {
+    interval cur = v[order[k]];
+    for (; k<n; ++k) {
+      const auto i = order[k];
+      if (v[i].isNA() || is_empty(v[i])) continue;
+      if (union_end_lt_start(cur, v[i])) {
+        res.push_back(cur);
+        cur = v[i];
+      } else if (union_end_lt(cur, v[i])) {
+        cur = interval(cur.getStart(), v[i].getEnd(), cur.sopen(), v[i].eopen());
+      } else if (cur.getEnd() == v[i].getEnd() && cur.eopen() && !v[i].eopen()) {
+        cur = interval(cur.getStart(), cur.getEnd(), cur.sopen(), false);
+      }
+      if (mapping_v[0]) map[i] = res.size() + 1;
+    }
+    res.push_back(cur);
+  }
 
-  // build the ComplexVector that we will return to R:
   Rcpp::ComplexVector finalres(res.size());
-  memcpy(&finalres[0], &res[0], sizeof(Rcomplex)*res.size());
-  return finalres;
+  if (res.size() > 0) memcpy(finalres.begin(), &res[0], sizeof(Rcomplex)*res.size());
+  if (!mapping_v[0]) {
+    return assignS4("nanoival", finalres);
+  }
+  return Rcpp::List::create(Rcpp::Named("x")   = assignS4("nanoival", finalres),
+                            Rcpp::Named("map") = map);
+}
+
+
+// Coverage of several 'nanoival' vectors: the times that belong to at least 'm' of the 'k'
+// vectors, which gives their union for 'm = 1' and their intersection for 'm = k'. Each vector
+// is first reduced to sorted, disjoint ranges of interval keys, on which touching intervals
+// are merged as in 'nanoival_reduce_impl'; the start and one-past-the-end of these ranges
+// are then merged across the 'k' vectors with a heap, keeping the number of vectors that
+// cover the current key, so that the result is produced in a single pass.
+typedef std::pair<std::int64_t, std::int64_t> KeyRange;
+
+static std::vector<KeyRange> coveredKeys(const interval* v, R_xlen_t n, bool sorted) {
+  std::vector<KeyRange> res;
+  std::vector<R_xlen_t> order;
+  if (sorted) {
+    order.resize(n);
+    std::iota(order.begin(), order.end(), 0);
+  } else {
+    order = radix_order(v, n, false);
+  }
+  for (auto i : order) {
+    if (v[i].isNA() || is_empty(v[i])) continue;
+    const auto sk = start_key(v[i]), ek = end_key(v[i]);
+    if (!res.empty() && sk <= res.back().second + 1) {
+      res.back().second = std::max(res.back().second, ek);
+    } else {
+      res.emplace_back(sk, ek);
+    }
+  }
+  return res;
 }
 
 // [[Rcpp::export]]
-Rcpp::ComplexVector nanoival_intersect_impl(const Rcpp::ComplexVector nv1,
-                                            const Rcpp::ComplexVector nv2) {
-  // assume 'nanoival1/2' were sorted at the R level
+Rcpp::ComplexVector nanoival_cover_impl(const Rcpp::List lst, const Rcpp::NumericVector m_v) {
+  if (m_v.size() != 1 || ISNAN(m_v[0]) || m_v[0] < 1) Rcpp::stop("'m' must be a number larger or equal to 1");
+  const double m = m_v[0];
+
+  const size_t k = lst.size();
+  std::vector<std::vector<KeyRange>> ranges(k);
+  for (size_t j=0; j<k; ++j) {
+    const SEXP x = lst[j];
+    ranges[j] = coveredKeys(readOnly<interval>(x), XLENGTH(x), isKnownSorted(x));
+  }
+
+  // vector 'j' is at the start of its range 'pos[j] / 2' if 'pos[j]' is even, and one past
+  // its end if it is odd:
+  std::vector<size_t> pos(k, 0);
+  auto next = [&ranges, &pos](size_t j) {
+    const auto& r = ranges[j][pos[j] / 2];
+    return pos[j] % 2 ? r.second + 1 : r.first;
+  };
+  typedef std::pair<std::int64_t, size_t> Event;
+  std::priority_queue<Event, std::vector<Event>, std::greater<Event>> heap;
+  for (size_t j=0; j<k; ++j) {
+    if (!ranges[j].empty()) heap.emplace(next(j), j);
+  }
+
   std::vector<interval> res;
-  const interval* v1 = reinterpret_cast<const interval*>(&nv1[0]);
-  const interval* v2 = reinterpret_cast<const interval*>(&nv2[0]);
+  size_t count = 0;
+  std::int64_t start = 0;
+  while (!heap.empty()) {
+    // apply all the events at this key before looking at the count:
+    const auto key = heap.top().first;
+    const auto before = count;
+    while (!heap.empty() && heap.top().first == key) {
+      const auto j = heap.top().second;
+      heap.pop();
+      if (pos[j] % 2) --count; else ++count;
+      if (++pos[j] < 2 * ranges[j].size()) heap.emplace(next(j), j);
+    }
+    if (before < m && count >= m) {
+      start = key;
+    } else if (before >= m && count < m) {
+      res.push_back(from_keys(start, key - 1));
+    }
+  }
 
-  R_xlen_t i1 = 0, i2 = 0;
-  while (i1 < nv1.size() && i2 < nv2.size()) {
+  Rcpp::ComplexVector finalres(res.size());
+  if (res.size() > 0) memcpy(finalres.begin(), &res[0], sizeof(Rcomplex)*res.size());
+  return assignS4("nanoival", finalres);
+}
+
+
+// Gaps between the intervals of a 'nanoival' vector or, if 'within_v' is a scalar, the
+// complement of the vector within that interval. The vector is first reduced to sorted,
+// disjoint key ranges as in 'nanoival_cover_impl'; a gap is then the range of keys strictly
+// between two consecutive ranges, so that each bound of a gap is open exactly when the bound
+// it touches is closed. Gaps shorter than 'minlen_v', if given, are dropped.
+// [[Rcpp::export]]
+Rcpp::ComplexVector nanoival_gaps_impl(SEXP x,
+                                       const Rcpp::ComplexVector within_v,   // empty or scalar
+                                       const Rcpp::NumericVector minlen_v) { // empty or scalar 'nanoduration'
+  if (within_v.size() > 1) Rcpp::stop("'within' must be scalar");
+  if (minlen_v.size() > 1) Rcpp::stop("'minlength' must be scalar");
+  std::int64_t minlen = 0;
+  if (minlen_v.size() == 1) {
+    memcpy(&minlen, reinterpret_cast<const char*>(&minlen_v[0]), sizeof(minlen));
+    if (minlen == NA_INTEGER64 || minlen < 0) Rcpp::stop("'minlength' must be a non-negative duration");
+  }
+
+  const auto ranges = coveredKeys(readOnly<interval>(x), XLENGTH(x), isKnownSorted(x));
+  Rcpp::ComplexVector res(allocShrinkable(CPLXSXP, ranges.size() + 1));
+  interval* out = reinterpret_cast<interval*>(res.begin());
+  R_xlen_t len = 0;
+  auto gap = [out, &len, minlen](std::int64_t sk, std::int64_t ek) {
+    if (sk > ek) return;
+    const auto ival = from_keys(sk, ek);
+    if (ival.e() - ival.s() >= minlen) out[len++] = ival;
+  };
+
+  if (within_v.size() == 0) {
+    for (size_t k=1; k<ranges.size(); ++k) {
+      gap(ranges[k-1].second + 1, ranges[k].first - 1);
+    }
+  } else {
+    const interval* w = reinterpret_cast<const interval*>(within_v.begin());
+    if (w->isNA()) Rcpp::stop("'within' must not be NA");
+    std::int64_t cur = start_key(*w);
+    const auto wend = end_key(*w);
+    for (const auto& r : ranges) {
+      if (r.second < cur) continue;
+      if (r.first > wend) break;
+      gap(cur, r.first - 1);
+      cur = r.second + 1;
+    }
+    gap(cur, wend);
+  }
+  Rcpp::ComplexVector finalres(shrinkVector(res, len));
+  return assignS4("nanoival", finalres);
+}
+
+
+static void intersect_range(const interval* v1, R_xlen_t n1, const interval* v2, R_xlen_t n2,
+                            const MergeRange& r, IntervalSink& res) {
+  R_xlen_t i1 = r.b1, i2 = r.b2;
+  while (i1 < n1 && i2 < n2 && (i1 < r.e1 || i2 < r.e2)) {
     if (v1[i1].getEnd() < v2[i2].getStart() || (v1[i1].getEnd() == v2[i2].getStart() && (v1[i1].eopen() || v2[i2].sopen()))) {
       ++i1;
       continue;
@@ -314,30 +955,29 @@ Rcpp::ComplexVector nanoival_intersect_impl(const Rcpp::ComplexVector nv1,
       }
     }
   }
-  
-  // build the ComplexVector that we will return to R:
-  Rcpp::ComplexVector finalres(res.size());
-  if (res.size() > 0) memcpy(&finalres[0], &res[0], sizeof(Rcomplex)*res.size());
-  return assignS4("nanoival", finalres);
 }
 
 // [[Rcpp::export]]
-Rcpp::ComplexVector nanoival_setdiff_impl(const Rcpp::ComplexVector nv1,
-                                          const Rcpp::ComplexVector nv2) {
+Rcpp::ComplexVector nanoival_intersect_impl(SEXP nv1,
+                                            SEXP nv2) {
   // assume 'nanoival1/2' were sorted at the R level
-  std::vector<interval> res;
-  const interval* v1 = reinterpret_cast<const interval*>(&nv1[0]);
-  const interval* v2 = reinterpret_cast<const interval*>(&nv2[0]);
+  auto finalres = mergeIntervals(nv1, nv2, intersect_range);
+  return assignS4("nanoival", finalres);
+}
 
-  R_xlen_t i1 = 0, i2 = 0;
+
+static void setdiff_range(const interval* v1, R_xlen_t n1, const interval* v2, R_xlen_t n2,
+                          const MergeRange& r, IntervalSink& res) {
+  R_xlen_t i1 = r.b1, i2 = r.b2;
+  if (i1 >= r.e1) return;
   auto start = v1[i1].getStart();
   auto sopen = v1[i1].sopen();
-  while (i1 < nv1.size() && i2 < nv2.size()) {
+  while (i1 < n1 && i2 < n2 && (i1 < r.e1 || i2 < r.e2)) {
     if (end_lt_start(v1[i1], v2[i2])) {
       // |-------------|
       //                 |------------|
       res.push_back(interval(start, v1[i1].getEnd(), sopen, v1[i1].eopen()));
-      if (++i1 >= nv1.size()) break;
+      if (++i1 >= n1) break;
       start = v1[i1].getStart();
       sopen = v1[i1].sopen();
     } else if (start_lt(v2[i2].getEnd(), v2[i2].eopen(), start, sopen)) {
@@ -357,7 +997,7 @@ Rcpp::ComplexVector nanoival_setdiff_impl(const Rcpp::ComplexVector nv1,
       } else {
         // |-------------|
         //        |------------|
-        if (++i1 >= nv1.size()) break;
+        if (++i1 >= n1) break;
         start = v1[i1].getStart();
         sopen = v1[i1].sopen();
       }
@@ -365,7 +1005,7 @@ Rcpp::ComplexVector nanoival_setdiff_impl(const Rcpp::ComplexVector nv1,
                end_ge(v2[i2], v1[i1])) {
       //    |-------|
       // |-------------|
-      if (++i1 >= nv1.size()) break;
+      if (++i1 >= n1) break;
       start = v1[i1].getStart();
       sopen = v1[i1].sopen();
     } else {
@@ -378,67 +1018,50 @@ Rcpp::ComplexVector nanoival_setdiff_impl(const Rcpp::ComplexVector nv1,
 
   }
   // remaining non-overlapping intervals in v1:
-  if (i1 < nv1.size()) {
+  if (i1 < r.e1) {
     res.push_back(interval(start, v1[i1].getEnd(), sopen, v1[i1].eopen()));
     ++i1;
-    while (i1 < nv1.size()) {
+    while (i1 < r.e1) {
       res.push_back(v1[i1++]);
     }
   }
-  
-  // build the ComplexVector that we will return to R:
-  Rcpp::ComplexVector finalres(res.size());
-  if (res.size() > 0) memcpy(&finalres[0], &res[0], sizeof(Rcomplex)*res.size());
-  return finalres;
 }
 
-
 // [[Rcpp::export]]
-bool nanoival_is_unsorted_impl(const Rcpp::ComplexVector nvec,
-                               const Rcpp::LogicalVector strictlyvec) {
-  if (strictlyvec.size() == 0) {
-    Rcpp::stop("argument 'strictly' cannot have length 0");
-  }
-  const bool strictlybool = strictlyvec[0];
-  const interval* ival_ptr = reinterpret_cast<const interval*>(&nvec[0]);
-  const auto ival_len = nvec.size();
-  if (strictlybool) {
-    for (R_xlen_t i=1; i<ival_len; ++i) {
-      if (ival_ptr[i-1] >= ival_ptr[i]) {
-        return true;
-      }
-    }
-  }
-  else {
-    for (R_xlen_t i=1; i<ival_len; ++i) {
-      if (ival_ptr[i-1] > ival_ptr[i]) {
-        return true;
-      }
-    }
-  }
-  return false;
+Rcpp::ComplexVector nanoival_setdiff_impl(SEXP nv1,
+                                          SEXP nv2) {
+  // assume 'nanoival1/2' were sorted at the R level
+  return mergeIntervals(nv1, nv2, setdiff_range);
 }
 
+
 // [[Rcpp::export]]
-const Rcpp::ComplexVector nanoival_sort_impl(const Rcpp::ComplexVector nvec,
+const Rcpp::ComplexVector nanoival_sort_impl(SEXP nvec,
                                              const Rcpp::LogicalVector decreasingvec) {
-  Rcpp::ComplexVector res = clone(nvec);
-  interval* ival_ptr = reinterpret_cast<interval*>(&res[0]);
-  const auto ival_len = res.size();
-  interval* start = ival_ptr;
-  interval* end   = start + ival_len;
-
   if (decreasingvec.size() == 0) {
     Rcpp::stop("argument 'decreasing' cannot have length 0");
-  } else if (!decreasingvec[0]) {
-    std::sort(start, end);
   }
-  else {
-    std::sort(start, end, std::greater<interval>());
+  const interval* v = readOnly<interval>(nvec);
+  Rcpp::ComplexVector res(XLENGTH(nvec));
+  DUPLICATE_ATTRIB(res, nvec);
+  interval* r = reinterpret_cast<interval*>(&res[0]);
+  const auto idx = radix_order(v, res.size(), decreasingvec[0]);
+  for (R_xlen_t i=0; i<res.size(); ++i) {
+    r[i] = v[idx[i]];
   }
   return res;
 }
 
+// [[Rcpp::export]]
+SEXP nanoival_order_impl(SEXP nvec,
+                         const Rcpp::LogicalVector decreasingvec) {
+  if (decreasingvec.size() == 0) {
+    Rcpp::stop("argument 'decreasing' cannot have length 0");
+  }
+  const interval* v = readOnly<interval>(nvec);
+  return radix_permutation(radix_order(v, XLENGTH(nvec), decreasingvec[0]));
+}
+
 // [[Rcpp::export]]
 const Rcpp::ComplexVector nanoival_sort_impl2(const Rcpp::ComplexVector nvec,	// #nocov start
                                               bool decreasing) {
@@ -456,19 +1079,74 @@ const Rcpp::ComplexVector nanoival_sort_impl2(const Rcpp::ComplexVector nvec,	//
   return res;
 }                                                                               // #nocov end
 
+// The order of intervals is the lexicographic order of their (start
+// key, end key) pairs: closed starts sort before open ones and open
+// ends before closed ones. The comparisons below work on the keys with
+// no branch, so that the loops of 'nanoival_comp' can be vectorised.
+struct ival_lt {
+  bool operator()(std::int64_t sk1, std::int64_t ek1, std::int64_t sk2, std::int64_t ek2) const {
+    return (sk1 < sk2) | ((sk1 == sk2) & (ek1 < ek2));
+  }
+};
+struct ival_le {
+  bool operator()(std::int64_t sk1, std::int64_t ek1, std::int64_t sk2, std::int64_t ek2) const {
+    return (sk1 < sk2) | ((sk1 == sk2) & (ek1 <= ek2));
+  }
+};
+struct ival_gt {
+  bool operator()(std::int64_t sk1, std::int64_t ek1, std::int64_t sk2, std::int64_t ek2) const {
+    return (sk1 > sk2) | ((sk1 == sk2) & (ek1 > ek2));
+  }
+};
+struct ival_ge {
+  bool operator()(std::int64_t sk1, std::int64_t ek1, std::int64_t sk2, std::int64_t ek2) const {
+    return (sk1 > sk2) | ((sk1 == sk2) & (ek1 >= ek2));
+  }
+};
+struct ival_eq {
+  bool operator()(std::int64_t sk1, std::int64_t ek1, std::int64_t sk2, std::int64_t ek2) const {
+    return (sk1 == sk2) & (ek1 == ek2);
+  }
+};
+struct ival_ne {
+  bool operator()(std::int64_t sk1, std::int64_t ek1, std::int64_t sk2, std::int64_t ek2) const {
+    return (sk1 != sk2) | (ek1 != ek2);
+  }
+};
+
 template<typename COMP>
 Rcpp::LogicalVector nanoival_comp(const Rcpp::ComplexVector v1,
                                   const Rcpp::ComplexVector v2, COMP cmp) {
   checkVectorsLengths(v1, v2);
-  Rcpp::LogicalVector res(getVectorLengths(v1, v2));
-  if (res.size()) {
-    const ConstPseudoVectorIval cv1(v1);
-    const ConstPseudoVectorIval cv2(v2);
-    const interval* n1_ptr = reinterpret_cast<const interval*>(&cv1[0]);
-    const interval* n2_ptr = reinterpret_cast<const interval*>(&cv2[0]);
-
-    for (R_xlen_t i=0; i<res.size(); ++i) {
-      res[i] = cmp(n1_ptr[i], n2_ptr[i]);
+  const R_xlen_t n = getVectorLengths(v1, v2);
+  Rcpp::LogicalVector res(n);
+  if (n) {
+    const interval* p1 = reinterpret_cast<const interval*>(v1.begin());
+    const interval* p2 = reinterpret_cast<const interval*>(v2.begin());
+    const R_xlen_t n1 = v1.size();
+    const R_xlen_t n2 = v2.size();
+    int* out = res.begin();
+
+    if (n1 == n2) {
+      for (R_xlen_t i=0; i<n; ++i) {
+        out[i] = cmp(start_key(p1[i]), end_key(p1[i]), start_key(p2[i]), end_key(p2[i]));
+      }
+    } else if (n2 == 1) {
+      const std::int64_t sk2 = start_key(p2[0]), ek2 = end_key(p2[0]);
+      for (R_xlen_t i=0; i<n; ++i) {
+        out[i] = cmp(start_key(p1[i]), end_key(p1[i]), sk2, ek2);
+      }
+    } else if (n1 == 1) {
+      const std::int64_t sk1 = start_key(p1[0]), ek1 = end_key(p1[0]);
+      for (R_xlen_t i=0; i<n; ++i) {
+        out[i] = cmp(sk1, ek1, start_key(p2[i]), end_key(p2[i]));
+      }
+    } else {
+      for (R_xlen_t i=0; i<n; ++i) {
+        const interval& i1 = p1[i % n1];
+        const interval& i2 = p2[i % n2];
+        out[i] = cmp(start_key(i1), end_key(i1), start_key(i2), end_key(i2));
+      }
     }
   
     copyNames(v1, v2, res);
@@ -478,32 +1156,32 @@ Rcpp::LogicalVector nanoival_comp(const Rcpp::ComplexVector v1,
 
 // [[Rcpp::export]]
 Rcpp::LogicalVector nanoival_lt_impl(const Rcpp::ComplexVector n1, const Rcpp::ComplexVector n2) {
-  return nanoival_comp(n1, n2, std::less<interval>());
+  return nanoival_comp(n1, n2, ival_lt());
 }
 
 // [[Rcpp::export]]
 Rcpp::LogicalVector nanoival_le_impl(const Rcpp::ComplexVector n1, const Rcpp::ComplexVector n2) {
-  return nanoival_comp(n1, n2, std::less_equal<interval>());
+  return nanoival_comp(n1, n2, ival_le());
 }
 
 // [[Rcpp::export]]
 Rcpp::LogicalVector nanoival_gt_impl(const Rcpp::ComplexVector n1, const Rcpp::ComplexVector n2) {
-  return nanoival_comp(n1, n2, std::greater<interval>());
+  return nanoival_comp(n1, n2, ival_gt());
 }
 
 // [[Rcpp::export]]
 Rcpp::LogicalVector nanoival_ge_impl(const Rcpp::ComplexVector n1, const Rcpp::ComplexVector n2) {
-  return nanoival_comp(n1, n2, std::greater_equal<interval>());
+  return nanoival_comp(n1, n2, ival_ge());
 }
 
 // [[Rcpp::export]]
 Rcpp::LogicalVector nanoival_eq_impl(const Rcpp::ComplexVector n1, const Rcpp::ComplexVector n2) {
-  return nanoival_comp(n1, n2, std::equal_to<interval>());
+  return nanoival_comp(n1, n2, ival_eq());
 }
 
 // [[Rcpp::export]]
 Rcpp::LogicalVector nanoival_ne_impl(Rcpp::ComplexVector n1, Rcpp::ComplexVector n2) {
-  return nanoival_comp(n1, n2, std::not_equal_to<interval>());
+  return nanoival_comp(n1, n2, ival_ne());
 }
 
 
@@ -552,15 +1230,18 @@ Rcpp::ComplexVector nanoival_minus_impl(const Rcpp::ComplexVector n1, const Rcpp
 template <typename T, typename U>
 static Rcpp::NumericVector setdiff_idx(const T* v1, size_t v1_size, const U* v2, size_t v2_size) {
   std::vector<double> res_first;
+  auto mode = selectGallop(v1_size, v2_size);
   size_t i1 = 0, i2 = 0;
   while (i1 < v1_size && i2 < v2_size) {
     if (v1[i1] < v2[i2]) {
-      res_first.push_back(i1+1);
-      ++i1;
+      const auto next = skip_times_before(v1, i1, v1_size, v2[i2], mode.times);
+      for (; i1 < next; ++i1) {
+        res_first.push_back(i1+1);
+      }
     } else if (v1[i1] > v2[i2]) {
-      ++i2;
+      i2 = skip_intervals_before(v2, i2, v2_size, v1[i1], mode);
     } else { 
-      ++i1;
+      i1 = skip_times_in(v1, i1, v1_size, v2[i2], mode.times);
     }
   }
 
@@ -578,13 +1259,113 @@ static Rcpp::NumericVector setdiff_idx(const T* v1, size_t v1_size, const U* v2,
 }
 
 // [[Rcpp::export]]
-Rcpp::NumericVector nanoival_setdiff_idx_time_interval_impl(const Rcpp::NumericVector nv1,
-                                                            const Rcpp::ComplexVector cv2) {
-  const dtime* v1 = reinterpret_cast<const dtime*>(&nv1[0]);
-  const interval* v2 = reinterpret_cast<const interval*>(&cv2[0]);
-  return setdiff_idx(v1, nv1.size(), v2, cv2.size());
+Rcpp::NumericVector nanoival_setdiff_idx_time_interval_impl(SEXP nv1,
+                                                            SEXP cv2) {
+  const dtime* v1 = readOnly<dtime>(nv1);
+  const interval* v2 = readOnly<interval>(cv2);
+  const R_xlen_t n1 = withoutTrailingNA(nv1);
+  const auto res = setdiff_idx(v1, n1, v2, XLENGTH(cv2));
+  if (n1 == XLENGTH(nv1)) {
+    return res;
+  }
+  // the trailing 'NA' are not in 'y':
+  Rcpp::NumericVector finalres(res.size() + XLENGTH(nv1) - n1);
+  std::copy(res.begin(), res.end(), finalres.begin());
+  std::iota(finalres.begin() + res.size(), finalres.end(), static_cast<double>(n1 + 1));
+  return finalres;
+}
+
+static const R_xlen_t PACK_BLOCK = 1024;
+
+// Bulk version of the 'interval' constructor: each input advances by
+// its increment, 1 for a full vector and 0 for a broadcast scalar. The
+// loop body is branch-free, with the same encoding as the constructor;
+// problems are only counted, block by block, and reported once at the
+// end instead of per element.
+static void packIntervals(interval* out, R_xlen_t n,
+                          const std::int64_t* s,  R_xlen_t s_inc,
+                          const std::int64_t* e,  R_xlen_t e_inc,
+                          const int* sopen,       R_xlen_t sopen_inc,
+                          const int* eopen,       R_xlen_t eopen_inc) {
+  const std::int64_t open_bit = std::int64_t{1} << 63;
+  std::int64_t* o = reinterpret_cast<std::int64_t*>(out);
+  R_xlen_t noverflow = 0, nreversed = 0, first_reversed = -1;
+
+  auto isna_at = [&](R_xlen_t i) {
+    return (s[i*s_inc] == NA_INTEGER64) | (e[i*e_inc] == NA_INTEGER64) |
+      (sopen[i*sopen_inc] == NA_LOGICAL) | (eopen[i*eopen_inc] == NA_LOGICAL);
+  };
+  auto outside_at = [&](R_xlen_t i) {
+    return (s[i*s_inc] < interval::IVAL_MIN) | (s[i*s_inc] > interval::IVAL_MAX) |
+      (e[i*e_inc] < interval::IVAL_MIN) | (e[i*e_inc] > interval::IVAL_MAX);
+  };
+
+  for (R_xlen_t b=0; b<n; b+=PACK_BLOCK) {
+    const R_xlen_t bend = std::min(n, b + PACK_BLOCK);
+    R_xlen_t block_overflow = 0, block_reversed = 0;
+    for (R_xlen_t i=b; i<bend; ++i) {
+      const std::int64_t si = s[i*s_inc];
+      const std::int64_t ei = e[i*e_inc];
+      const int soi = sopen[i*sopen_inc];
+      const int eoi = eopen[i*eopen_inc];
+      const bool na = isna_at(i);
+      const bool overflow = outside_at(i) & !na;
+      const bool isna = na | overflow;
+      const bool reversed = (ei < si) & !isna;
+      o[2*i]   = isna ? interval::IVAL_NA : (si | (soi ? open_bit : 0));
+      o[2*i+1] = isna ? interval::IVAL_NA : (ei | (eoi ? open_bit : 0));
+      block_overflow += overflow;
+      block_reversed += reversed;
+    }
+    if (block_reversed && first_reversed < 0) {
+      // rescan the block to report the first offending interval:
+      first_reversed = b;
+      while (isna_at(first_reversed) || outside_at(first_reversed) ||
+             e[first_reversed*e_inc] >= s[first_reversed*s_inc]) {
+        ++first_reversed;
+      }
+    }
+    noverflow += block_overflow;
+    nreversed += block_reversed;
+  }
+
+  if (nreversed) {
+    std::stringstream ss;
+    ss << "interval end (" << e[first_reversed*e_inc]
+       << ") smaller than interval start (" << s[first_reversed*s_inc] << ")";
+    if (nreversed > 1) {
+      ss << " at index " << first_reversed + 1 << " and " << nreversed - 1 << " other intervals";
+    }
+    Rcpp::stop(ss.str());
+  }
+  if (noverflow) {
+    Rf_warning("NAs produced by time overflow (remember that interval times are coded with 63 bits)");
+  }
+}
+
+
+// [[Rcpp::export]]
+Rcpp::S4 nanoival_pack_impl(const Rcpp::NumericVector sv,
+                            const Rcpp::NumericVector ev,
+                            const Rcpp::LogicalVector sopenv,
+                            const Rcpp::LogicalVector eopenv) {
+  // inverse of 'nanoival_unpack_impl': the four components are
+  // parallel arrays, so no recycling is needed and each interval is
+  // written in place:
+  const R_xlen_t n = sv.size();
+  if (ev.size() != n || sopenv.size() != n || eopenv.size() != n) {
+    Rcpp::stop("'start', 'end', 'sopen' and 'eopen' must have the same length");
+  }
+  Rcpp::ComplexVector res(n);
+  packIntervals(reinterpret_cast<interval*>(res.begin()), n,
+                reinterpret_cast<const std::int64_t*>(sv.begin()), 1,
+                reinterpret_cast<const std::int64_t*>(ev.begin()), 1,
+                sopenv.begin(), 1,
+                eopenv.begin(), 1);
+  return assignS4("nanoival", res);
 }
 
+
 // [[Rcpp::export]]
 Rcpp::S4 nanoival_new_impl(const Rcpp::NumericVector sv,
                            const Rcpp::NumericVector ev,
@@ -592,46 +1373,87 @@ Rcpp::S4 nanoival_new_impl(const Rcpp::NumericVector sv,
                            const Rcpp::LogicalVector eopenv) {
 
   // handle the special case where one of the operands has 0-length:
-  Rcpp::ComplexVector res(getVectorLengths(sv, ev, sopenv, eopenv));
+  const R_xlen_t n = getVectorLengths(sv, ev, sopenv, eopenv);
+  auto bulk = [n](R_xlen_t len) { return len == n || len == 1; };
+  if (bulk(sv.size()) && bulk(ev.size()) && bulk(sopenv.size()) && bulk(eopenv.size())) {
+    // no recycling other than of scalars, so we can use the bulk path:
+    Rcpp::ComplexVector res(n);
+    packIntervals(reinterpret_cast<interval*>(res.begin()), n,
+                  reinterpret_cast<const std::int64_t*>(sv.begin()), sv.size() == n,
+                  reinterpret_cast<const std::int64_t*>(ev.begin()), ev.size() == n,
+                  sopenv.begin(), sopenv.size() == n,
+                  eopenv.begin(), eopenv.size() == n);
+    return assignS4("nanoival", res);
+  }
 
+  Rcpp::ComplexVector res(n);
   checkVectorsLengths(sv, ev, sopenv, eopenv);
   const ConstPseudoVectorNum nvs(sv);
   const ConstPseudoVectorNum nve(ev);
   const ConstPseudoVectorLgl lvs(sopenv);
   const ConstPseudoVectorLgl lve(eopenv);
 
-  for (R_xlen_t i=0; i < res.size(); ++i) {
+  interval* out = reinterpret_cast<interval*>(res.begin());
+  for (R_xlen_t i=0; i < n; ++i) {
     const double d1 = nvs[i];
     const double d2 = nve[i];
     dtime i1, i2;
     memcpy(&i1, reinterpret_cast<const char*>(&d1), sizeof(d1));
     memcpy(&i2, reinterpret_cast<const char*>(&d2), sizeof(d2));
-    const interval ival { i1, i2, lvs[i], lve[i] };
-    memcpy(&res[i], &ival, sizeof(ival));
+    out[i] = interval(i1, i2, lvs[i], lve[i]);
   }
   return assignS4("nanoival", res);
 }
 
 
+// [[Rcpp::export]]
+Rcpp::List nanoival_unpack_impl(const Rcpp::ComplexVector cv) {
+  // decode all the components in a single pass; the loop body has no
+  // branch, so that it can be vectorised:
+  const R_xlen_t n = cv.size();
+  Rcpp::NumericVector start(n);
+  Rcpp::NumericVector end(n);
+  Rcpp::LogicalVector sopen(n);
+  Rcpp::LogicalVector eopen(n);
+  Rcpp::LogicalVector na(n);
+  const interval* v = reinterpret_cast<const interval*>(cv.begin());
+  std::int64_t* s = reinterpret_cast<std::int64_t*>(start.begin());
+  std::int64_t* e = reinterpret_cast<std::int64_t*>(end.begin());
+  int* so = sopen.begin();
+  int* eo = eopen.begin();
+  int* isna = na.begin();
+  for (R_xlen_t i=0; i<n; ++i) {
+    const bool ivalna = v[i].isNA();
+    s[i]    = ivalna ? NA_INTEGER64 : v[i].s();
+    e[i]    = ivalna ? NA_INTEGER64 : v[i].e();
+    so[i]   = ivalna ? NA_LOGICAL : v[i].sopen();
+    eo[i]   = ivalna ? NA_LOGICAL : v[i].eopen();
+    isna[i] = ivalna;
+  }
+  assignS4("nanotime", start, "integer64");
+  assignS4("nanotime", end, "integer64");
+  SEXP names = Rf_getAttrib(cv, R_NamesSymbol);
+  start.names() = names;
+  end.names()   = names;
+  sopen.names() = names;
+  eopen.names() = names;
+  na.names()    = names;
+  return Rcpp::List::create(Rcpp::Named("start") = start,
+                            Rcpp::Named("end")   = end,
+                            Rcpp::Named("sopen") = sopen,
+                            Rcpp::Named("eopen") = eopen,
+                            Rcpp::Named("na")    = na);
+}
+
+
 // R accessor functions:
 // [[Rcpp::export]]
 Rcpp::NumericVector nanoival_get_start_impl(const Rcpp::ComplexVector cv) {
   Rcpp::NumericVector res(cv.size());
+  const interval* v = reinterpret_cast<const interval*>(cv.begin());
+  std::int64_t* s = reinterpret_cast<std::int64_t*>(res.begin());
   for (R_xlen_t i=0; i<cv.size(); ++i) {
-    interval ival;
-    Rcomplex c = cv[i];
-    memcpy(&ival, reinterpret_cast<const char*>(&c), sizeof(c));
-    if (ival.isNA()) {
-      double d;
-      memcpy(&d, reinterpret_cast<const char*>(&NA_INTEGER64), sizeof(NA_INTEGER64));
-      res[i] = d;
-    }
-    else {
-      std::int64_t start = ival.s();
-      double d;
-      memcpy(&d, reinterpret_cast<const char*>(&start), sizeof(start));
-      res[i] = d;
-    }
+    s[i] = v[i].isNA() ? NA_INTEGER64 : v[i].s();
   }
   assignS4("nanotime", res, "integer64");
   res.names() = cv.names();
@@ -642,21 +1464,10 @@ Rcpp::NumericVector nanoival_get_start_impl(const Rcpp::ComplexVector cv) {
 // [[Rcpp::export]]
 Rcpp::NumericVector nanoival_get_end_impl(const Rcpp::ComplexVector cv) {
   Rcpp::NumericVector res(cv.size());
+  const interval* v = reinterpret_cast<const interval*>(cv.begin());
+  std::int64_t* e = reinterpret_cast<std::int64_t*>(res.begin());
   for (R_xlen_t i=0; i<cv.size(); ++i) {
-    interval ival;
-    Rcomplex c = cv[i];
-    memcpy(&ival, reinterpret_cast<const char*>(&c), sizeof(c));
-    if (ival.isNA()) {
-      double d;
-      memcpy(&d, reinterpret_cast<const char*>(&NA_INTEGER64), sizeof(NA_INTEGER64));
-      res[i] = d;
-    }
-    else {
-      std::int64_t end = ival.e();
-      double d;
-      memcpy(&d, reinterpret_cast<const char*>(&end), sizeof(end));
-      res[i] = d;
-    }
+    e[i] = v[i].isNA() ? NA_INTEGER64 : v[i].e();
   }
   assignS4("nanotime", res, "integer64");
   res.names() = cv.names();
@@ -667,16 +1478,10 @@ Rcpp::NumericVector nanoival_get_end_impl(const Rcpp::ComplexVector cv) {
 // [[Rcpp::export]]
 Rcpp::LogicalVector nanoival_get_sopen_impl(const Rcpp::ComplexVector cv) {
   Rcpp::LogicalVector res(cv.size());
+  const interval* v = reinterpret_cast<const interval*>(cv.begin());
+  int* so = res.begin();
   for (R_xlen_t i=0; i<cv.size(); ++i) {
-    interval ival;
-    Rcomplex c = cv[i];
-    memcpy(&ival, reinterpret_cast<const char*>(&c), sizeof(c));
-    if (ival.isNA()) {
-      res[i] = NA_LOGICAL;
-    }
-    else {
-      res[i] = ival.sopen();
-    }
+    so[i] = v[i].isNA() ? NA_LOGICAL : v[i].sopen();
   }
   res.names() = cv.names();
   return res;
@@ -686,16 +1491,10 @@ Rcpp::LogicalVector nanoival_get_sopen_impl(const Rcpp::ComplexVector cv) {
 // [[Rcpp::export]]
 Rcpp::LogicalVector nanoival_get_eopen_impl(const Rcpp::ComplexVector cv) {
   Rcpp::LogicalVector res(cv.size());
+  const interval* v = reinterpret_cast<const interval*>(cv.begin());
+  int* eo = res.begin();
   for (R_xlen_t i=0; i<cv.size(); ++i) {
-    interval ival;
-    Rcomplex c = cv[i];
-    memcpy(&ival, reinterpret_cast<const char*>(&c), sizeof(c));
-    if (ival.isNA()) {
-      res[i] = NA_LOGICAL;
-    }
-    else {
-      res[i] = ival.eopen();
-    }
+    eo[i] = v[i].isNA() ? NA_LOGICAL : v[i].eopen();
   }
   res.names() = cv.names();
   return res;
@@ -809,19 +1608,21 @@ Rcomplex getNA_ival() {
 
 
 // [[Rcpp::export]]
-Rcpp::ComplexVector nanoival_subset_numeric_impl(const Rcpp::ComplexVector& v, const Rcpp::NumericVector& idx) {
+SEXP nanoival_subset_numeric_impl(SEXP v_s, SEXP idx_s) {
+  // a contiguous range of indices gives a view that shares the data of 'v':
+  const SEXP view = sliceView(v_s, idx_s);
+  if (view != R_NilValue) return view;
+  const Rcpp::NumericVector idx(idx_s);
   Rcpp::ComplexVector res(0);
-  std::vector<Rcomplex> res_c;    // by declaring it here we can make subset logical agnostic to 'Rcomplex'
-  subset_numeric(v, idx, res, res_c, getNA_ival);
+  subset_numeric(v_s, idx, res, getNA_ival);
   return assignS4("nanoival", res);
 }
 
 
 // [[Rcpp::export]]
-Rcpp::ComplexVector nanoival_subset_logical_impl(const Rcpp::ComplexVector& v, const Rcpp::LogicalVector& idx_p) {
+Rcpp::ComplexVector nanoival_subset_logical_impl(SEXP v, const Rcpp::LogicalVector& idx_p) {
   const ConstPseudoVectorLgl idx(idx_p);
   Rcpp::ComplexVector res(0);
-  std::vector<Rcomplex> res_c;
-  subset_logical(v, idx, res, res_c, getNA_ival);
+  subset_logical(v, idx, res, getNA_ival);
   return assignS4("nanoival", res);
 }
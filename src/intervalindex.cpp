@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <numeric>
+#include <Rcpp.h>
+#include "nanotime/interval.hpp"
+#include "nanotime/parallel.hpp"
+
+
+using namespace nanotime;
+
+
+// A persistent index over a 'nanoival' vector that need be neither sorted nor
+// non-overlapping, answering "which intervals contain this time" (and "which intervals
+// overlap this interval") in logarithmic time plus the size of the answer.
+//
+// The intervals are sorted on their start and laid out as an implicit augmented interval
+// tree: the leaves are at the even positions, the node at level 'k' is at a position whose
+// lowest 'k' bits are set and it covers the '2^(k+1) - 1' positions around it, and each
+// node stores the maximum end of the intervals it covers. Bounds are compared on the integer
+// keys of interval.hpp so that open and closed bounds need no special casing.
+
+struct IntervalIndex {
+  struct Node {
+    std::int64_t st;            // start key
+    std::int64_t en;            // end key
+    std::int64_t mx;            // maximum end key over the subtree rooted here
+    R_xlen_t orig;              // 0-based position in the indexed vector
+  };
+
+  std::vector<Node> nodes;
+  int max_level = -1;
+
+  explicit IntervalIndex(const interval* v, R_xlen_t n) {
+    for (R_xlen_t i=0; i<n; ++i) {
+      if (!v[i].isNA() && !is_empty(v[i])) {
+        nodes.push_back(Node{ start_key(v[i]), end_key(v[i]), end_key(v[i]), i });
+      }
+    }
+    std::sort(nodes.begin(), nodes.end(), [](const Node& a, const Node& b) {
+      return a.st < b.st || (a.st == b.st && a.orig < b.orig);
+    });
+    build();
+  }
+
+  // call 'f(orig)' for each interval whose keys overlap '[lo, hi]':
+  template <typename F>
+  void overlaps(std::int64_t lo, std::int64_t hi, F f) const {
+    if (max_level < 0) return;
+    const R_xlen_t n = nodes.size();
+    struct Frame { int k; R_xlen_t x; bool left_done; };
+    Frame stack[128];
+    int t = 0;
+    stack[t++] = Frame{ max_level, (R_xlen_t(1) << max_level) - 1, false };
+    while (t) {
+      const Frame z = stack[--t];
+      if (z.k <= 3) {
+        // small subtree, a linear scan is faster:
+        const R_xlen_t i0 = z.x >> z.k << z.k;
+        const R_xlen_t i1 = std::min(n, i0 + (R_xlen_t(1) << (z.k + 1)) - 1);
+        for (R_xlen_t i=i0; i<i1 && nodes[i].st <= hi; ++i) {
+          if (nodes[i].en >= lo) f(nodes[i].orig);
+        }
+      } else if (!z.left_done) {
+        // revisit this node once the left child is done; the left child may be past the
+        // end of the vector, in which case its own left subtree is not:
+        const R_xlen_t y = z.x - (R_xlen_t(1) << (z.k - 1));
+        stack[t++] = Frame{ z.k, z.x, true };
+        if (y >= n || nodes[y].mx >= lo) {
+          stack[t++] = Frame{ z.k - 1, y, false };
+        }
+      } else if (z.x < n && nodes[z.x].st <= hi) {
+        if (nodes[z.x].en >= lo) f(nodes[z.x].orig);
+        stack[t++] = Frame{ z.k - 1, z.x + (R_xlen_t(1) << (z.k - 1)), false };
+      }
+    }
+  }
+
+private:
+  void build() {
+    const R_xlen_t n = nodes.size();
+    if (n == 0) return;
+    R_xlen_t last_i = 0;
+    std::int64_t last = 0;      // maximum end of the subtree of 'last_i'
+    for (R_xlen_t i=0; i<n; i+=2) {
+      last_i = i;
+      last = nodes[i].mx = nodes[i].en;
+    }
+    int k = 1;
+    for (; (R_xlen_t(1) << k) <= n; ++k) {
+      const R_xlen_t x = R_xlen_t(1) << (k - 1), i0 = (x << 1) - 1, step = x << 2;
+      for (R_xlen_t i=i0; i<n; i+=step) {
+        const auto el = nodes[i - x].mx;
+        const auto er = i + x < n ? nodes[i + x].mx : last;
+        nodes[i].mx = std::max(nodes[i].en, std::max(el, er));
+      }
+      last_i = (last_i >> k & 1) ? last_i - x : last_i + x;
+      if (last_i < n && nodes[last_i].mx > last) {
+        last = nodes[last_i].mx;
+      }
+    }
+    max_level = k - 1;
+  }
+};
+
+
+static IntervalIndex* getIndex(SEXP xp_sexp) {
+  Rcpp::XPtr<IntervalIndex> xp(xp_sexp);
+  if (xp.get() == nullptr) {
+    Rcpp::stop("'index' is not valid anymore: an index cannot be saved and restored");
+  }
+  return xp.get();
+}
+
+
+// [[Rcpp::export]]
+SEXP nanoival_index_impl(const Rcpp::ComplexVector cv) {
+  const interval* v = reinterpret_cast<const interval*>(cv.begin());
+  Rcpp::XPtr<IntervalIndex> xp(new IntervalIndex(v, cv.size()), true);
+  xp.attr("class") = "nanoival.index";
+  return xp;
+}
+
+
+// Run the queries 'getkeys(i)' for 'i' in '[0, n)' against 'index'; 'getkeys' returns false
+// for a query that cannot match anything. The counts are computed first, then, unless only
+// the counts are wanted, the pairs are written at the offsets given by the counts, each
+// query's matches in increasing order of interval:
+template <typename KEYS>
+static SEXP stab(const IntervalIndex& index, R_xlen_t n, KEYS getkeys, const Rcpp::LogicalVector& count_v) {
+  if (count_v.size() != 1 || count_v[0] == NA_LOGICAL) Rcpp::stop("'count' must be a non-NA logical scalar");
+
+  Rcpp::NumericVector counts(n);
+  double* cnt = counts.begin();
+  parallel_for(n, [&](R_xlen_t begin, R_xlen_t end) {
+    for (R_xlen_t i=begin; i<end; ++i) {
+      std::int64_t lo, hi;
+      R_xlen_t c = 0;
+      if (getkeys(i, lo, hi)) {
+        index.overlaps(lo, hi, [&c](R_xlen_t) { ++c; });
+      }
+      cnt[i] = c;
+    }
+  });
+  if (count_v[0]) {
+    return counts;
+  }
+
+  std::vector<R_xlen_t> offsets(n + 1);
+  for (R_xlen_t i=0; i<n; ++i) {
+    offsets[i+1] = offsets[i] + static_cast<R_xlen_t>(cnt[i]);
+  }
+  Rcpp::NumericVector res_x(offsets[n]), res_y(offsets[n]);
+  double* px = res_x.begin();
+  double* py = res_y.begin();
+  parallel_for(n, [&](R_xlen_t begin, R_xlen_t end) {
+    for (R_xlen_t i=begin; i<end; ++i) {
+      if (offsets[i] == offsets[i+1]) continue;
+      std::int64_t lo, hi;
+      getkeys(i, lo, hi);
+      R_xlen_t o = offsets[i];
+      index.overlaps(lo, hi, [&o, py](R_xlen_t orig) { py[o++] = orig + 1; });
+      std::sort(py + offsets[i], py + offsets[i+1]);
+      std::fill(px + offsets[i], px + offsets[i+1], static_cast<double>(i + 1));
+    }
+  });
+
+  return Rcpp::List::create(Rcpp::Named("x") = res_x,
+                            Rcpp::Named("y") = res_y);
+}
+
+
+// [[Rcpp::export]]
+SEXP nanoival_stab_time_impl(SEXP xp, const Rcpp::NumericVector nv, const Rcpp::LogicalVector count_v) {
+  const IntervalIndex* index = getIndex(xp);
+  const dtime* v = reinterpret_cast<const dtime*>(nv.begin());
+  return stab(*index, nv.size(), [v](R_xlen_t i, std::int64_t& lo, std::int64_t& hi) {
+    if (v[i].time_since_epoch() == duration::min()) return false;
+    lo = hi = time_key(v[i]);
+    return true;
+  }, count_v);
+}
+
+
+// [[Rcpp::export]]
+SEXP nanoival_stab_interval_impl(SEXP xp, const Rcpp::ComplexVector cv, const Rcpp::LogicalVector count_v) {
+  const IntervalIndex* index = getIndex(xp);
+  const interval* v = reinterpret_cast<const interval*>(cv.begin());
+  return stab(*index, cv.size(), [v](R_xlen_t i, std::int64_t& lo, std::int64_t& hi) {
+    if (v[i].isNA() || is_empty(v[i])) return false;
+    lo = start_key(v[i]);
+    hi = end_key(v[i]);
+    return true;
+  }, count_v);
+}
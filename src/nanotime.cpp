@@ -3,8 +3,10 @@
 #include <Rcpp.h>
 #include <RcppCCTZ_API.h>
 #include "nanotime/globals.hpp"
+#include "nanotime/period.hpp"
 #include "nanotime/utilities.hpp"
 #include "nanotime/pseudovector.hpp"
+#include "nanotime/parallel.hpp"
 
 
 using namespace nanotime;
@@ -15,99 +17,73 @@ typedef ConstPseudoVector<STRSXP,  const Rcpp::CharacterVector::const_Proxy> Con
 typedef ConstPseudoVector<LGLSXP,  std::int32_t> ConstPseudoVectorLgl;
 
 
-static inline duration getOffsetCnv(const dtime& dt, const std::string& z) {
-  int offset;
-  int res = RcppCCTZ::getOffset(std::chrono::duration_cast<std::chrono::seconds>(dt.time_since_epoch()).count(), z.c_str(), offset);
-  if (res < 0) {
-    Rcpp::stop("Cannot retrieve timezone '%s'.", z.c_str());
-  }
-  return duration(offset).count() * std::chrono::seconds(1);
-}
-
-// [[Rcpp::export]]
-Rcpp::IntegerVector nanotime_wday_impl(const Rcpp::NumericVector tm_v,
-                                       const Rcpp::CharacterVector tz_v) {
+// apply 'field' to the local day of each element of 'tm_v':
+template <typename F>
+static Rcpp::IntegerVector calendar_field(const Rcpp::NumericVector& tm_v,
+                                          const Rcpp::CharacterVector& tz_v,
+                                          F field) {
   checkVectorsLengths(tm_v, tz_v);
   Rcpp::IntegerVector    res(getVectorLengths(tm_v, tz_v));
   if (res.size()) {
-    ConstPseudoVectorInt64 tm(tm_v);
-    ConstPseudoVectorChar  tz(tz_v);
-
-    for (R_xlen_t i=0; i<res.size(); ++i) {
-      const auto tz_i = Rcpp::as<std::string>(tz[i]);
-      const auto tm_i = *reinterpret_cast<const dtime*>(&tm[i]);
-      const auto offset = getOffsetCnv(tm_i, tz_i.c_str());
-      date::sys_days t_days = date::floor<date::days>(tm_i + offset);
-      res[i] = unsigned(date::weekday(t_days).c_encoding());
+    if (tz_v.size() == 1) {
+      // the common case of a scalar timezone: it is resolved once here, on the main thread,
+      // which also loads it in the 'cctz' cache; the work can then be split across threads:
+      const auto tz_0  = Rcpp::as<std::string>(tz_v[0]);
+      const auto tm    = reinterpret_cast<const dtime*>(tm_v.begin());
+      auto       res_p = res.begin();
+      getOffsetCnv(tm[0], tz_0);
+      parallel_for(res.size(), [&tz_0, tm, res_p, &field](R_xlen_t begin, R_xlen_t end) {
+        for (R_xlen_t i=begin; i<end; ++i) {
+          const auto offset = getOffsetCnvThreadSafe(tm[i], tz_0);
+          res_p[i] = field(date::floor<date::days>(tm[i] + offset));
+        }
+      });
+    } else {
+      ConstPseudoVectorInt64 tm(tm_v);
+      ConstPseudoVectorChar  tz(tz_v);
+
+      for (R_xlen_t i=0; i<res.size(); ++i) {
+        const auto tz_i = Rcpp::as<std::string>(tz[i]);
+        const auto tm_i = *reinterpret_cast<const dtime*>(&tm[i]);
+        const auto offset = getOffsetCnv(tm_i, tz_i.c_str());
+        res[i] = field(date::floor<date::days>(tm_i + offset));
+      }
     }
     copyNames(tm_v, tz_v, res);
   }
   return res;
 }
 
+// [[Rcpp::export]]
+Rcpp::IntegerVector nanotime_wday_impl(const Rcpp::NumericVector tm_v,
+                                       const Rcpp::CharacterVector tz_v) {
+  return calendar_field(tm_v, tz_v, [](const date::sys_days& t_days) {
+    return int(unsigned(date::weekday(t_days).c_encoding()));
+  });
+}
+
 // [[Rcpp::export]]
 Rcpp::IntegerVector nanotime_mday_impl(const Rcpp::NumericVector tm_v,
                                        const Rcpp::CharacterVector tz_v) {
-  checkVectorsLengths(tm_v, tz_v);
-  Rcpp::IntegerVector    res(getVectorLengths(tm_v, tz_v));
-  if (res.size()) {
-    ConstPseudoVectorInt64 tm(tm_v);
-    ConstPseudoVectorChar  tz(tz_v);
-    for (R_xlen_t i=0; i<res.size(); ++i) {
-      const auto tz_i = Rcpp::as<std::string>(tz[i]);
-      const auto tm_i = *reinterpret_cast<const dtime*>(&tm[i]);
-      const auto offset = getOffsetCnv(tm_i, tz_i.c_str());
-      date::sys_days t_days = date::floor<date::days>(tm_i + offset);
-      date::weekday wd(t_days);
-      res[i] = unsigned(date::year_month_day(t_days).day());
-    }
-    copyNames(tm_v, tz_v, res);
-  }
-  return res;
+  return calendar_field(tm_v, tz_v, [](const date::sys_days& t_days) {
+    return int(unsigned(date::year_month_day(t_days).day()));
+  });
 }
 
 // [[Rcpp::export]]
 Rcpp::IntegerVector nanotime_month_impl(const Rcpp::NumericVector tm_v,
                                         const Rcpp::CharacterVector tz_v) {
-  checkVectorsLengths(tm_v, tz_v);
-  Rcpp::IntegerVector    res(getVectorLengths(tm_v, tz_v));
-  if (res.size()) {
-    ConstPseudoVectorInt64 tm(tm_v);
-    ConstPseudoVectorChar  tz(tz_v);
-
-    for (R_xlen_t i=0; i<res.size(); ++i) {
-      const auto tz_i = Rcpp::as<std::string>(tz[i]);
-      const auto tm_i = *reinterpret_cast<const dtime*>(&tm[i]);
-      const auto offset = getOffsetCnv(tm_i, tz_i.c_str());
-      date::sys_days t_days = date::floor<date::days>(tm_i + offset);
-      date::weekday wd(t_days);
-      res[i] = unsigned(date::year_month_day(t_days).month());
-    }
-    copyNames(tm_v, tz_v, res);
-  }
-  return res;
+  return calendar_field(tm_v, tz_v, [](const date::sys_days& t_days) {
+    return int(unsigned(date::year_month_day(t_days).month()));
+  });
 }
 
 // [[Rcpp::export]]
 Rcpp::IntegerVector nanotime_year_impl(const Rcpp::NumericVector tm_v,
                                        const Rcpp::CharacterVector tz_v) {
-  checkVectorsLengths(tm_v, tz_v);
-  Rcpp::IntegerVector    res(getVectorLengths(tm_v, tz_v));
-  if (res.size()) {
-    ConstPseudoVectorInt64 tm(tm_v);
-    ConstPseudoVectorChar  tz(tz_v);
-
-    for (R_xlen_t i=0; i<res.size(); ++i) {
-      const auto tz_i = Rcpp::as<std::string>(tz[i]);
-      const auto tm_i = *reinterpret_cast<const dtime*>(&tm[i]);
-      const auto offset = getOffsetCnv(tm_i, tz_i.c_str());
-      date::sys_days t_days = date::floor<date::days>(tm_i + offset);
-      date::weekday wd(t_days);
-      res[i] = int(date::year_month_day(t_days).year());
-    }
-    copyNames(tm_v, tz_v, res);
-  }
-  return res;
+  return calendar_field(tm_v, tz_v, [](const date::sys_days& t_days) {
+    return int(date::year_month_day(t_days).year());
+  });
 }
 
 
@@ -166,19 +142,21 @@ static double getNA_nanotime() {
 
 
 // [[Rcpp::export]]
-Rcpp::NumericVector nanotime_subset_numeric_impl(const Rcpp::NumericVector& v, const Rcpp::NumericVector& idx) {
+SEXP nanotime_subset_numeric_impl(SEXP v_s, SEXP idx_s) {
+  // a contiguous range of indices gives a view that shares the data of 'v':
+  const SEXP view = sliceView(v_s, idx_s);
+  if (view != R_NilValue) return view;
+  const Rcpp::NumericVector idx(idx_s);
   Rcpp::NumericVector res(0);
-  std::vector<double> res_c;    // by declaring it here we can make subset logical agnostic to double
-  subset_numeric(v, idx, res, res_c, getNA_nanotime);
+  subset_numeric(v_s, idx, res, getNA_nanotime);
   return assignS4("nanotime", res, "integer64");
 }
 
 
 // [[Rcpp::export]]
-Rcpp::NumericVector nanotime_subset_logical_impl(const Rcpp::NumericVector& v, const Rcpp::LogicalVector& idx_p) {
+Rcpp::NumericVector nanotime_subset_logical_impl(SEXP v, const Rcpp::LogicalVector& idx_p) {
   const ConstPseudoVectorLgl idx(idx_p);
   Rcpp::NumericVector res(0);
-  std::vector<double> res_c;    // by declaring it here we can make subset logical agnostic to double
-  subset_logical(v, idx, res, res_c, getNA_nanotime);
+  subset_logical(v, idx, res, getNA_nanotime);
   return assignS4("nanotime", res, "integer64");
 }
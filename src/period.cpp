@@ -769,19 +769,21 @@ static Rcomplex getNA_complex() {
 }
 
 // [[Rcpp::export]]
-Rcpp::ComplexVector period_subset_numeric_impl(const Rcpp::ComplexVector& v, const Rcpp::NumericVector& idx) {
+SEXP period_subset_numeric_impl(SEXP v_s, SEXP idx_s) {
+  // a contiguous range of indices gives a view that shares the data of 'v':
+  const SEXP view = sliceView(v_s, idx_s);
+  if (view != R_NilValue) return view;
+  const Rcpp::NumericVector idx(idx_s);
   Rcpp::ComplexVector res(0);
-  std::vector<Rcomplex> res_c;    // by declaring it here we can make subset logical agnostic to 'Rcomplex'
-  subset_numeric(v, idx, res, res_c, getNA_complex);
+  subset_numeric(v_s, idx, res, getNA_complex);
   return assignS4("nanoperiod", res);
 }
 
 
 // [[Rcpp::export]]
-Rcpp::ComplexVector period_subset_logical_impl(const Rcpp::ComplexVector& v, const Rcpp::LogicalVector& idx_p) {
+Rcpp::ComplexVector period_subset_logical_impl(SEXP v, const Rcpp::LogicalVector& idx_p) {
   const ConstPseudoVectorBool idx(idx_p);
   Rcpp::ComplexVector res(0);
-  std::vector<Rcomplex> res_c;    // by declaring it here we can make subset logical agnostic to 'Rcomplex'
-  subset_logical(v, idx, res, res_c, getNA_complex);
+  subset_logical(v, idx, res, getNA_complex);
   return assignS4("nanoperiod", res);
 }
@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <deque>
+#include <Rcpp.h>
+#include <RcppCCTZ_API.h>
+#include "nanotime/period.hpp"
+#include "nanotime/utilities.hpp"
+
+
+using namespace nanotime;
+
+
+// C++-level rolling window aggregations: for each element 't' of a sorted 'nanotime' vector
+// the window is the interval 't - window -> t', the bounds of which are open or closed
+// following the same semantic as 'sopen' and 'eopen' of 'interval'.
+
+enum class RollingStat { COUNT, SUM, MEAN, MIN, MAX };
+
+
+static std::vector<RollingStat> getRollingStats(const Rcpp::CharacterVector& stats_v) {
+  std::vector<RollingStat> res;
+  for (R_xlen_t i=0; i<stats_v.size(); ++i) {
+    const auto s = Rcpp::as<std::string>(stats_v[i]);
+    if      (s == "count") res.push_back(RollingStat::COUNT);
+    else if (s == "sum")   res.push_back(RollingStat::SUM);
+    else if (s == "mean")  res.push_back(RollingStat::MEAN);
+    else if (s == "min")   res.push_back(RollingStat::MIN);
+    else if (s == "max")   res.push_back(RollingStat::MAX);
+    else Rcpp::stop("unknown rolling statistic '" + s + "'");
+  }
+  return res;
+}
+
+
+// find, in one pass, the first element ('lo') and one past the last element ('hi') of each
+// window; because 'dt' is sorted 'hi' only ever moves forward, and so does 'lo' when the
+// window start is 'monotone' in 't'. Subtracting a period with days or months is not: for
+// instance 2021-03-31 minus one month is 2021-03-03 but 2021-04-01 minus one month is
+// 2021-03-01, so in that case 'lo' is found by binary search:
+template <typename START>
+static void windowBounds(const dtime* dt, R_xlen_t n, START getstart, bool monotone, bool sopen, bool eopen,
+                         std::vector<R_xlen_t>& lo_v, std::vector<R_xlen_t>& hi_v) {
+  R_xlen_t lo = 0, hi = 0;
+  for (R_xlen_t i=0; i<n; ++i) {
+    const auto end   = dt[i];
+    const auto start = getstart(dt[i]);
+    while (hi < n && (eopen ? dt[hi] < end : dt[hi] <= end)) ++hi;
+    if (monotone) {
+      while (lo < hi && (sopen ? dt[lo] <= start : dt[lo] < start)) ++lo;
+    } else {
+      lo = (sopen ? std::upper_bound(dt, dt + hi, start) : std::lower_bound(dt, dt + hi, start)) - dt;
+    }
+    lo_v[i] = lo;
+    hi_v[i] = hi;
+  }
+}
+
+
+// running state of one numeric column over the current window '[a, b)'; NA and infinite
+// values are counted separately so that the finite sum can be maintained incrementally, and
+// the min/max are maintained with monotone deques of indices. The window can also grow
+// back at the start ('unpop'), when the window start is not monotone:
+struct WindowState {
+  const double* x;
+  R_xlen_t a = 0, b = 0;
+  double sum = 0;
+  R_xlen_t n_na = 0, n_pinf = 0, n_ninf = 0;
+  std::deque<R_xlen_t> dqmin, dqmax;
+
+  WindowState(const double* x_p) : x(x_p) { }
+
+  void push() {
+    const auto v = x[b];
+    if      (ISNAN(v))     ++n_na;
+    else if (v == R_PosInf) ++n_pinf;
+    else if (v == R_NegInf) ++n_ninf;
+    else sum += v;
+    if (!ISNAN(v)) {
+      while (!dqmin.empty() && x[dqmin.back()] >= v) dqmin.pop_back();
+      dqmin.push_back(b);
+      while (!dqmax.empty() && x[dqmax.back()] <= v) dqmax.pop_back();
+      dqmax.push_back(b);
+    }
+    ++b;
+  }
+
+  void pop() {
+    const auto v = x[a];
+    if      (ISNAN(v))     --n_na;
+    else if (v == R_PosInf) --n_pinf;
+    else if (v == R_NegInf) --n_ninf;
+    else sum -= v;
+    ++a;
+    if (a == b) sum = 0;        // don't let rounding errors accumulate across empty windows
+    while (!dqmin.empty() && dqmin.front() < a) dqmin.pop_front();
+    while (!dqmax.empty() && dqmax.front() < a) dqmax.pop_front();
+  }
+
+  void unpop() {
+    --a;
+    const auto v = x[a];
+    if      (ISNAN(v))     ++n_na;
+    else if (v == R_PosInf) ++n_pinf;
+    else if (v == R_NegInf) ++n_ninf;
+    else sum += v;
+    // 'v' is the oldest element, so it only matters if it is strictly the new min or max:
+    if (!ISNAN(v)) {
+      if (dqmin.empty() || v < x[dqmin.front()]) dqmin.push_front(a);
+      if (dqmax.empty() || v > x[dqmax.front()]) dqmax.push_front(a);
+    }
+  }
+
+  void moveTo(R_xlen_t lo, R_xlen_t hi) {
+    while (b < hi) push();
+    while (a > lo) unpop();
+    while (a < lo) pop();
+  }
+
+  double getSum() const {
+    if (n_na)              return NA_REAL;
+    if (n_pinf && n_ninf)  return R_NaN;
+    if (n_pinf)            return R_PosInf;
+    if (n_ninf)            return R_NegInf;
+    return sum;
+  }
+
+  double getMean() const {
+    return a == b ? NA_REAL : getSum() / (b - a);
+  }
+
+  double getMin() const {
+    return a == b || n_na ? NA_REAL : x[dqmin.front()];
+  }
+
+  double getMax() const {
+    return a == b || n_na ? NA_REAL : x[dqmax.front()];
+  }
+};
+
+
+template <typename START>
+static Rcpp::List rolling(SEXP nt_s,
+                          START getstart,
+                          bool monotone,
+                          const Rcpp::List& cols,
+                          const Rcpp::CharacterVector& stats_v,
+                          const Rcpp::LogicalVector& sopen_v,
+                          const Rcpp::LogicalVector& eopen_v) {
+  if (sopen_v.size() != 1 || sopen_v[0] == NA_LOGICAL) Rcpp::stop("'sopen' must be a non-NA logical scalar");
+  if (eopen_v.size() != 1 || eopen_v[0] == NA_LOGICAL) Rcpp::stop("'eopen' must be a non-NA logical scalar");
+
+  const auto n     = XLENGTH(nt_s);
+  const auto stats = getRollingStats(stats_v);
+  for (R_xlen_t j=0; j<cols.size(); ++j) {
+    if (TYPEOF(cols[j]) != REALSXP || XLENGTH(cols[j]) != n) {
+      Rcpp::stop("columns must be numeric vectors of the same length as 'x'");
+    }
+  }
+
+  const auto dt = readOnly<dtime>(nt_s);
+  std::vector<R_xlen_t> lo(n), hi(n);
+  windowBounds(dt, n, getstart, monotone, sopen_v[0], eopen_v[0], lo, hi);
+
+  // 'count' does not depend on the columns, so it is returned once; the other statistics
+  // are returned for each column in turn:
+  Rcpp::List res;
+  for (auto s : stats) {
+    if (s == RollingStat::COUNT) {
+      Rcpp::NumericVector count(n);
+      for (R_xlen_t i=0; i<n; ++i) count[i] = hi[i] - lo[i];
+      res.push_back(count);
+      break;
+    }
+  }
+
+  for (R_xlen_t j=0; j<cols.size(); ++j) {
+    const Rcpp::NumericVector col = cols[j];
+    std::vector<Rcpp::NumericVector> out;
+    std::vector<RollingStat> outstats;
+    for (auto s : stats) {
+      if (s != RollingStat::COUNT) {
+        out.push_back(Rcpp::NumericVector(n));
+        outstats.push_back(s);
+      }
+    }
+    if (out.empty()) break;
+
+    WindowState w(col.begin());
+    for (R_xlen_t i=0; i<n; ++i) {
+      w.moveTo(lo[i], hi[i]);
+      for (size_t k=0; k<out.size(); ++k) {
+        switch (outstats[k]) {
+        case RollingStat::SUM:  out[k][i] = w.getSum();  break;
+        case RollingStat::MEAN: out[k][i] = w.getMean(); break;
+        case RollingStat::MIN:  out[k][i] = w.getMin();  break;
+        case RollingStat::MAX:  out[k][i] = w.getMax();  break;
+        default: break;
+        }
+      }
+    }
+    for (auto& o : out) res.push_back(o);
+  }
+
+  return res;
+}
+
+
+// [[Rcpp::export]]
+Rcpp::List rolling_impl(SEXP                         nt_s,      // sorted vector of 'nanotime'
+                        const Rcpp::NumericVector&   dur_v,     // scalar duration
+                        const Rcpp::List&            cols,      // list of numeric columns
+                        const Rcpp::CharacterVector& stats_v,   // statistics to compute
+                        const Rcpp::LogicalVector&   sopen_v,   // is the window start open
+                        const Rcpp::LogicalVector&   eopen_v) { // is the window end open
+  if (dur_v.size() != 1) Rcpp::stop("'window' must be scalar");
+
+  duration dur; memcpy(&dur, reinterpret_cast<const char*>(&dur_v[0]), sizeof(duration));
+  if (dur == duration::min() || dur < duration::zero()) {
+    Rcpp::stop("'window' must be non-negative");
+  }
+
+  return rolling(nt_s, [dur](const dtime& t) { return t - dur; }, true, cols, stats_v, sopen_v, eopen_v);
+}
+
+
+// [[Rcpp::export]]
+Rcpp::List rolling_tz_impl(SEXP                         nt_s,      // sorted vector of 'nanotime'
+                           const Rcpp::ComplexVector&   prd_v,     // scalar period
+                           const Rcpp::List&            cols,      // list of numeric columns
+                           const Rcpp::CharacterVector& stats_v,   // statistics to compute
+                           const Rcpp::LogicalVector&   sopen_v,   // is the window start open
+                           const Rcpp::LogicalVector&   eopen_v,   // is the window end open
+                           const Rcpp::CharacterVector& tz_v) {    // scalar timezone
+  if (prd_v.size() != 1) Rcpp::stop("'window' must be scalar");
+  if (tz_v.size() != 1)  Rcpp::stop("'tz' must be scalar");
+
+  period prd; memcpy(&prd, reinterpret_cast<const char*>(&prd_v[0]), sizeof(period));
+  if (prd.isNA() || prd.getMonths() < 0 || prd.getDays() < 0 || prd.getDuration() < duration::zero()) {
+    Rcpp::stop("'window' must be non-negative");
+  }
+  const auto tz = Rcpp::as<std::string>(tz_v[0]);
+
+  const bool monotone = prd.getMonths() == 0 && prd.getDays() == 0;
+  return rolling(nt_s, [&prd, &tz](const dtime& t) { return minus(t, prd, tz); }, monotone,
+                 cols, stats_v, sopen_v, eopen_v);
+}
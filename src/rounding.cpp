@@ -2,6 +2,7 @@
 #include <RcppCCTZ_API.h>
 #include "nanotime/period.hpp"
 #include "nanotime/utilities.hpp"
+#include "nanotime/parallel.hpp"
 
 
 using namespace nanotime;
@@ -64,7 +65,8 @@ static RoundingPrecision selectPrecision(const period p) {
   if       (p.getMonths() >= 1)
     return isMultipleOf(p, year) ? RoundingPrecision::YEAR : RoundingPrecision::MONTH;
   else if  (p.getDays() >= 1)
-    return RoundingPrecision::DAY;
+    // only a whole number of weeks is anchored on week starts:
+    return p.getDays() % 7 == 0 && p.getDuration() == duration::zero() ? RoundingPrecision::WEEK : RoundingPrecision::DAY;
   else if  (p.getDuration() >= std::chrono::hours{1})
     return (isMultipleOf(p.getDuration(), std::chrono::hours{24})) ? RoundingPrecision::DAY : selectPrecision(p.getDuration());
   else
@@ -113,7 +115,22 @@ static dtime floor(dtime t, RoundingPrecision p) {
 }
 
 
-static dtime floor_tz(const dtime t, RoundingPrecision p, const std::string& z) {
+static inline int64_t floordiv(int64_t a, int64_t b) {
+  return a / b - (a % b != 0 && (a < 0) != (b < 0));
+}
+
+
+// the first day of the week that contains 't_days', with weeks starting on 'week_start' (0 is
+// Sunday); when 'nweeks' is larger than 1, the weeks are grouped by 'nweeks' counting from the
+// first week after the epoch, so that the grouping depends only on 't_days' and not on the data:
+static date::sys_days floor_week(const date::sys_days t_days, int week_start, int nweeks) {
+  const int64_t first = (week_start - 4 + 7) % 7; // 1970-01-01 is a Thursday
+  const auto week = floordiv(t_days.time_since_epoch().count() - first, 7);
+  return date::sys_days{date::days{first + 7 * floordiv(week, nweeks) * nweeks}};
+}
+
+
+static dtime floor_tz(const dtime t, RoundingPrecision p, const std::string& z, int week_start, int nweeks) {
   using namespace std::chrono;
   switch (p) {
   case RoundingPrecision::HOUR: {
@@ -128,6 +145,11 @@ static dtime floor_tz(const dtime t, RoundingPrecision p, const std::string& z)
     auto t_days = date::floor<date::days>(t + getOffsetCnv(t, z.c_str()));
     return t_days - getOffsetCnv(t_days, z.c_str());
   }
+  case RoundingPrecision::WEEK: {
+    auto t_days = date::floor<date::days>(t + getOffsetCnv(t, z.c_str()));
+    t_days = floor_week(t_days, week_start, nweeks);
+    return t_days - getOffsetCnv(t_days, z.c_str());
+  }
   case RoundingPrecision::MONTH: {
     auto t_days = date::floor<date::days>(t + getOffsetCnv(t, z.c_str()));
     auto ymd = date::year_month_day(t_days);
@@ -146,13 +168,23 @@ static dtime floor_tz(const dtime t, RoundingPrecision p, const std::string& z)
 }
 
 
+static int getWeekStart(const Rcpp::IntegerVector& week_start_v) {
+  if (week_start_v.size() != 1 || week_start_v[0] == NA_INTEGER || week_start_v[0] < 0 || week_start_v[0] > 6) {
+    Rcpp::stop("'week_start' must be an integer scalar between 0 (Sunday) and 6 (Saturday)");
+  }
+  return week_start_v[0];
+}
+
+
 static const std::vector<dtime> makegrid(const dtime start,
                                          bool absolute_start,          // is start absolute (e.g no rounding)
                                          const dtime end,
                                          const period p,
-                                         const std::string& tz) {
+                                         const std::string& tz,
+                                         int week_start) {
   const auto precision = selectPrecision(p);
-  const auto start_0   = absolute_start ? start : floor_tz(start, precision, tz);
+  const auto nweeks    = precision == RoundingPrecision::WEEK ? p.getDays() / 7 : 1;
+  const auto start_0   = absolute_start ? start : floor_tz(start, precision, tz, week_start, nweeks);
   const auto end_0     = plus(end, p, tz);
 
   std::vector<dtime> res;
@@ -166,40 +198,176 @@ static const std::vector<dtime> makegrid(const dtime start,
 }
 
 
-static void ceilingtogrid(const dtime* dt, const uint64_t n_dt, const std::vector<dtime>& grid, dtime* res) {
+static void ceilingtogrid(const dtime* dt, const R_xlen_t n_dt, const std::vector<dtime>& grid, dtime* res) {
   if (grid.size() <= 1) {
     throw std::range_error("ceilingtogrid: invalid 'grid' argument"); // not reachable in this context #nocov
   }
 
-  size_t iy = 0;
+  // each chunk seeds its own cursor in the grid, after which the grid is walked forward:
+  parallel_for(n_dt, [dt, &grid, res](R_xlen_t begin, R_xlen_t end) {
+    if (begin == end) return;
+    size_t iy = std::lower_bound(grid.begin(), grid.end(), dt[begin]) - grid.begin();
 
-  for (size_t ix=0; ix < n_dt; ++ix) {
-    while (dt[ix] > grid[iy]) ++iy;
-    res[ix] = grid[iy];         // this is safe by grid construction
-  }
+    for (R_xlen_t ix=begin; ix < end; ++ix) {
+      while (dt[ix] > grid[iy]) ++iy;
+      res[ix] = grid[iy];         // this is safe by grid construction
+    }
+  });
 }
 
 
-// this is really the same as 
-static void floortogrid(const dtime* dt, const uint64_t n_dt, const std::vector<dtime>& grid, dtime* res) {
+// this is really the same as above, but calls 'out(ix, k)' with the index 'k' in the grid of the
+// floor of 'dt[ix]', so that the caller can get either the rounded value or the bucket ordinal:
+template <typename OUT>
+static void floortogrid(const dtime* dt, const R_xlen_t n_dt, const std::vector<dtime>& grid, OUT out) {
   if (grid.size() <= 1) {
     throw std::range_error("floortogrid: invalid 'grid' argument"); // not reachable in this context #nocov
   }
   
-  size_t iy = 1;
+  // each chunk seeds its own cursor in the grid, after which the grid is walked forward:
+  parallel_for(n_dt, [dt, &grid, &out](R_xlen_t begin, R_xlen_t end) {
+    if (begin == end) return;
+    size_t iy = std::upper_bound(grid.begin(), grid.end(), dt[begin]) - grid.begin();
+    iy = std::max(iy, size_t(1));
+
+    for (R_xlen_t ix=begin; ix < end; ++ix) {
+      while (dt[ix] >= grid[iy]) ++iy;
+      out(ix, iy-1);            // this is safe by grid construction
+    }
+  });
+}
 
-  for (size_t ix=0; ix < n_dt; ++ix) {
-    while (dt[ix] >= grid[iy]) ++iy;
-    res[ix] = grid[iy-1];      // this is safe by grid construction
+
+// epoch-anchored grid: the bucket of a time is computed from its local civil time alone, counting
+// buckets from 1970-01-01 00:00 local time (or from the first week after that date for a period
+// that is a whole number of weeks); the result therefore doesn't depend on the rest of the data,
+// and the vector doesn't need to be sorted:
+struct EpochGrid {
+  enum class Unit { MONTH, DAY, DURATION };
+
+  EpochGrid(const period& p, int week_start) {
+    const bool has_dur = p.getDuration() != duration::zero();
+    if (p.getMonths() && !p.getDays() && !has_dur) {
+      unit = Unit::MONTH; step = p.getMonths(); anchor = 0;
+    } else if (!p.getMonths() && p.getDays() && !has_dur) {
+      unit = Unit::DAY;   step = p.getDays();
+      anchor = p.getDays() % 7 == 0 ? (week_start - 4 + 7) % 7 : 0; // 1970-01-01 is a Thursday
+    } else if (!p.getMonths() && !p.getDays() && has_dur) {
+      unit = Unit::DURATION; step = p.getDuration().count(); anchor = 0;
+    } else {
+      Rcpp::stop("an epoch-anchored 'precision' must have exactly one non-zero component among months, days and duration");
+    }
+  }
+
+  // index of the bucket containing 't':
+  int64_t index(const dtime t, const std::string& tz) const {
+    const auto t_local = t + getOffsetCnvThreadSafe(t, tz);
+    switch (unit) {
+    case Unit::MONTH: {
+      const auto ymd = date::year_month_day(date::floor<date::days>(t_local));
+      const int64_t m = (int(ymd.year()) - 1970) * 12 + unsigned(ymd.month()) - 1;
+      return floordiv(m, step);
+    }
+    case Unit::DAY:
+      return floordiv(date::floor<date::days>(t_local).time_since_epoch().count() - anchor, step);
+    default:
+      return floordiv(t_local.time_since_epoch().count(), step);
+    }
+  }
+
+  // same as 'index', but corrected for the rare case where the start of the bucket is after 't':
+  int64_t floorIndex(const dtime t, const std::string& tz) const {
+    const auto idx = index(t, tz);
+    return start(idx, tz, t) > t ? idx - 1 : idx;
+  }
+
+  // start time of the bucket 'idx'; of the two instants of an ambiguous local time, the one
+  // with the offset of 'hint' is taken if there is one:
+  dtime start(const int64_t idx, const std::string& tz, const dtime hint) const {
+    return localToUtc(localStart(idx), tz, getOffsetCnvThreadSafe(hint, tz));
+  }
+
+private:
+  // local civil time of the start of the bucket 'idx':
+  dtime localStart(const int64_t idx) const {
+    switch (unit) {
+    case Unit::MONTH: {
+      const auto m = idx * step;
+      return date::sys_days(date::year(static_cast<int>(1970 + floordiv(m, 12))) /
+                            date::month(static_cast<unsigned>(m - 12 * floordiv(m, 12) + 1)) /
+                            date::day(1));
+    }
+    case Unit::DAY:
+      return date::sys_days{date::days{anchor + idx * step}};
+    default:
+      return dtime{duration{idx * step}};
+    }
+  }
+
+  // the instant of the local time 't_local': the offset 'offset' is tried first, then the
+  // offset in effect at the time that gives; when neither is consistent, 't_local' is skipped by
+  // a transition, and the transition itself, the first instant after 't_local', is returned:
+  static dtime localToUtc(const dtime t_local, const std::string& tz, const duration offset) {
+    const auto t1 = t_local - offset;
+    const auto offset1 = getOffsetCnvThreadSafe(t1, tz);
+    if (offset1 == offset) return t1;
+    const auto t2 = t_local - offset1;
+    const auto offset2 = getOffsetCnvThreadSafe(t2, tz);
+    if (offset2 == offset1) return t2;
+
+    // the transition is in '(lo, hi]', which is at most the size of the jump in offset:
+    auto lo = std::min(t1, t2), hi = std::max(t1, t2);
+    const auto offset_hi = getOffsetCnvThreadSafe(hi, tz);
+    while (hi - lo > duration{1}) {
+      const auto mid = lo + (hi - lo) / 2;
+      if (getOffsetCnvThreadSafe(mid, tz) == offset_hi) hi = mid; else lo = mid;
+    }
+    return hi;
   }
+
+  Unit unit;
+  int64_t step;                 // in months, days or nanoseconds
+  int64_t anchor;               // day number of the start of bucket 0 for 'DAY'
+};
+
+
+static void epochindex(const dtime* dt, const R_xlen_t n_dt, const EpochGrid& grid, const std::string& tz,
+                       int64_t* res) {
+  const dtime na = dtime{duration{NA_INTEGER64}};
+  parallel_for(n_dt, [dt, &grid, &tz, res, na](R_xlen_t begin, R_xlen_t end) {
+    for (R_xlen_t i=begin; i < end; ++i) {
+      res[i] = dt[i] == na ? NA_INTEGER64 : grid.floorIndex(dt[i], tz);
+    }
+  });
+}
+
+
+static void epochround(const dtime* dt, const R_xlen_t n_dt, const EpochGrid& grid, const std::string& tz,
+                       bool ceiling, dtime* res) {
+  const dtime na = dtime{duration{NA_INTEGER64}};
+  parallel_for(n_dt, [dt, &grid, &tz, ceiling, res, na](R_xlen_t begin, R_xlen_t end) {
+    for (R_xlen_t i=begin; i < end; ++i) {
+      if (dt[i] == na) {
+        res[i] = na;
+        continue;
+      }
+      const auto idx = grid.floorIndex(dt[i], tz);
+      res[i] = grid.start(idx, tz, dt[i]);
+      if (ceiling && res[i] != dt[i]) {
+        res[i] = grid.start(idx + 1, tz, dt[i]);
+      }
+    }
+  });
 }
 
 
 // [[Rcpp::export]]
-Rcpp::NumericVector ceiling_tz_impl(const Rcpp::NumericVector&   nt_v,      // vector of 'nanotime'
+Rcpp::NumericVector ceiling_tz_impl(SEXP                         nt_s,      // vector of 'nanotime'
                                     const Rcpp::ComplexVector&   prd_v,     // scalar period
                                     const Rcpp::NumericVector&   orig_v,    // origin                                    
-                                    const Rcpp::CharacterVector& tz_v) {    // scalar timezone
+                                    const Rcpp::CharacterVector& tz_v,      // scalar timezone
+                                    const Rcpp::IntegerVector&   week_start_v,   // first day of the week, 0 is Sunday
+                                    const Rcpp::LogicalVector&   epoch_v) {      // is the grid anchored on the epoch
   // check tz and orig are scalar:
   if (orig_v.size() > 1) {
     Rcpp::stop("'origin' must be scalar");
@@ -207,6 +375,13 @@ Rcpp::NumericVector ceiling_tz_impl(const Rcpp::NumericVector&   nt_v,      // v
   if (tz_v.size() > 1) {
     Rcpp::stop("'tz' must be scalar");
   }
+  const auto week_start = getWeekStart(week_start_v);
+  if (epoch_v.size() != 1 || epoch_v[0] == NA_LOGICAL) {
+    Rcpp::stop("'epoch' must be a non-NA logical scalar");
+  }
+  if (epoch_v[0] && orig_v.size()) {
+    Rcpp::stop("'origin' cannot be specified for an epoch-anchored grid");
+  }
 
   period prd; memcpy(&prd, reinterpret_cast<const char*>(&prd_v[0]), sizeof(period));
   const auto tz = Rcpp::as<std::string>(tz_v[0]);
@@ -217,7 +392,18 @@ Rcpp::NumericVector ceiling_tz_impl(const Rcpp::NumericVector&   nt_v,      // v
     Rcpp::stop("'precision' must be strictly positive");
   }
 
-  const dtime* dt = reinterpret_cast<const dtime*>(&nt_v[0]);
+  const R_xlen_t n = XLENGTH(nt_s);
+  const auto dt = readOnly<dtime>(nt_s);
+
+  if (epoch_v[0]) {
+    const EpochGrid grid(prd, week_start);
+    Rcpp::NumericVector res(n);
+    if (n) {
+      getOffsetCnv(dt[0], tz);  // validate 'tz' on the main thread
+      epochround(dt, n, grid, tz, true, reinterpret_cast<dtime*>(&res[0]));
+    }
+    return assignS4("nanotime", res, "integer64");
+  }
   
   dtime origin;
   if (orig_v.size()) {
@@ -228,20 +414,20 @@ Rcpp::NumericVector ceiling_tz_impl(const Rcpp::NumericVector&   nt_v,      // v
   }
   
   const auto grid = orig_v.size() ?
-    makegrid(origin, true,  dt[nt_v.size()-1], prd, tz) :
-    makegrid(dt[0],  false, dt[nt_v.size()-1], prd, tz);
+    makegrid(origin, true,  dt[n-1], prd, tz, week_start) :
+    makegrid(dt[0],  false, dt[n-1], prd, tz, week_start);
 
-  Rcpp::NumericVector res(nt_v.size());
+  Rcpp::NumericVector res(n);
   auto res_dt = reinterpret_cast<dtime*>(&res[0]);
   
-  ceilingtogrid(dt, nt_v.size(), grid, res_dt);
+  ceilingtogrid(dt, n, grid, res_dt);
 
   return assignS4("nanotime", res, "integer64");
 }
 
 
 // [[Rcpp::export]]
-Rcpp::NumericVector ceiling_impl(const Rcpp::NumericVector& nt_v,      // vector of 'nanotime'
+Rcpp::NumericVector ceiling_impl(SEXP                       nt_s,      // vector of 'nanotime'
                                  const Rcpp::NumericVector& dur_v,     // scalar duration
                                  const Rcpp::NumericVector& orig_v) {  // scalar origin
 
@@ -257,17 +443,19 @@ Rcpp::NumericVector ceiling_impl(const Rcpp::NumericVector& nt_v,      // vector
     Rcpp::stop("'precision' must be strictly positive");
   }
 
-  const auto* dt = reinterpret_cast<const int64_t*>(&nt_v[0]);
-  Rcpp::NumericVector res(nt_v.size());
+  const auto dt = readOnly<int64_t>(nt_s);
+  Rcpp::NumericVector res(XLENGTH(nt_s));
   auto res_dur = reinterpret_cast<int64_t*>(&res[0]);
   const auto origin = orig_v.size() ? *reinterpret_cast<const int64_t*>(&orig_v[0]) : 0;
 
-  for (R_xlen_t i=0; i < res.size(); ++i) {
-    res_dur[i] = ((dt[i] - origin) / dur) * dur + origin;
-    if (res_dur[i] > 0 && res_dur[i] < dt[i]) { // round up
-      res_dur[i] += dur;
+  parallel_for(res.size(), [dt, res_dur, origin, dur](R_xlen_t begin, R_xlen_t end) {
+    for (R_xlen_t i=begin; i < end; ++i) {
+      res_dur[i] = ((dt[i] - origin) / dur) * dur + origin;
+      if (res_dur[i] > 0 && res_dur[i] < dt[i]) { // round up
+        res_dur[i] += dur;
+      }
     }
-  }  
+  });
     
   return assignS4("nanotime", res, "integer64");
   return res;
@@ -275,10 +463,12 @@ Rcpp::NumericVector ceiling_impl(const Rcpp::NumericVector& nt_v,      // vector
 
  
 // [[Rcpp::export]]
-Rcpp::NumericVector floor_tz_impl(const Rcpp::NumericVector&   nt_v,      // vector of 'nanotime'
+Rcpp::NumericVector floor_tz_impl(SEXP                         nt_s,      // vector of 'nanotime'
                                   const Rcpp::ComplexVector&   prd_v,     // scalar period
                                   const Rcpp::NumericVector&   orig_v,    // origin
-                                  const Rcpp::CharacterVector& tz_v) {    // scalar timezone
+                                  const Rcpp::CharacterVector& tz_v,      // scalar timezone
+                                  const Rcpp::IntegerVector&   week_start_v,   // first day of the week, 0 is Sunday
+                                  const Rcpp::LogicalVector&   epoch_v) {      // is the grid anchored on the epoch
   // check tz and orig are scalar:
   if (orig_v.size() > 1) {
     Rcpp::stop("'origin' must be scalar");
@@ -286,6 +476,13 @@ Rcpp::NumericVector floor_tz_impl(const Rcpp::NumericVector&   nt_v,      // vec
   if (tz_v.size() > 1) {
     Rcpp::stop("'tz' must be scalar");
   }
+  const auto week_start = getWeekStart(week_start_v);
+  if (epoch_v.size() != 1 || epoch_v[0] == NA_LOGICAL) {
+    Rcpp::stop("'epoch' must be a non-NA logical scalar");
+  }
+  if (epoch_v[0] && orig_v.size()) {
+    Rcpp::stop("'origin' cannot be specified for an epoch-anchored grid");
+  }
 
   const auto tz = Rcpp::as<std::string>(tz_v[0]);
   period prd; memcpy(&prd, reinterpret_cast<const char*>(&prd_v[0]), sizeof(period));
@@ -296,7 +493,18 @@ Rcpp::NumericVector floor_tz_impl(const Rcpp::NumericVector&   nt_v,      // vec
     Rcpp::stop("'precision' must be strictly positive");
   }
 
-  const auto dt = reinterpret_cast<const dtime*>(&nt_v[0]);
+  const R_xlen_t n = XLENGTH(nt_s);
+  const auto dt = readOnly<dtime>(nt_s);
+
+  if (epoch_v[0]) {
+    const EpochGrid grid(prd, week_start);
+    Rcpp::NumericVector res(n);
+    if (n) {
+      getOffsetCnv(dt[0], tz);  // validate 'tz' on the main thread
+      epochround(dt, n, grid, tz, false, reinterpret_cast<dtime*>(&res[0]));
+    }
+    return assignS4("nanotime", res, "integer64");
+  }
   
   dtime origin;
   if (orig_v.size()) {
@@ -310,20 +518,29 @@ Rcpp::NumericVector floor_tz_impl(const Rcpp::NumericVector&   nt_v,      // vec
   // additionally if origin is supplied, verify it's not more than one interval before the first observation LLL
   
   const auto grid = orig_v.size() ?
-    makegrid(origin, true,  dt[nt_v.size()-1], prd, tz) :
-    makegrid(dt[0],  false, dt[nt_v.size()-1], prd, tz);
+    makegrid(origin, true,  dt[n-1], prd, tz, week_start) :
+    makegrid(dt[0],  false, dt[n-1], prd, tz, week_start);
 
-  Rcpp::NumericVector res(nt_v.size());
+  Rcpp::NumericVector res(n);
   auto res_dt = reinterpret_cast<dtime*>(&res[0]);
   
-  floortogrid(dt, nt_v.size(), grid, res_dt);
+  floortogrid(dt, n, grid, [&grid, res_dt](R_xlen_t ix, size_t k) { res_dt[ix] = grid[k]; });
 
   return assignS4("nanotime", res, "integer64");
 }
 
 
+static inline int64_t floor_duration(int64_t t, int64_t dur, int64_t origin) {
+  auto res = ((t - origin) / dur) * dur + origin;
+  if (res < 0 && res > t) {
+    res -= dur;
+  }
+  return res;
+}
+
+
 // [[Rcpp::export]]
-Rcpp::NumericVector floor_impl(const Rcpp::NumericVector& nt_v,      // vector of 'nanotime'
+Rcpp::NumericVector floor_impl(SEXP                       nt_s,      // vector of 'nanotime'
                                const Rcpp::NumericVector& dur_v,     // scalar duration
                                const Rcpp::NumericVector& orig_v) {  // origin
 
@@ -337,17 +554,220 @@ Rcpp::NumericVector floor_impl(const Rcpp::NumericVector& nt_v,      // vector o
     Rcpp::stop("'precision' must be strictly positive");
   }
 
-  const auto* dt = reinterpret_cast<const int64_t*>(&nt_v[0]);
-  Rcpp::NumericVector res(nt_v.size());
+  const auto dt = readOnly<int64_t>(nt_s);
+  Rcpp::NumericVector res(XLENGTH(nt_s));
   auto res_dur = reinterpret_cast<int64_t*>(&res[0]);
   const auto origin = orig_v.size() ? *reinterpret_cast<const int64_t*>(&orig_v[0]) : 0;
 
-  for (R_xlen_t i=0; i < res.size(); ++i) {
-    res_dur[i] = ((dt[i] - origin) / dur) * dur + origin;
-    if (res_dur[i] < 0 && res_dur[i] > dt[i]) {
-      res_dur[i] -= dur;
+  parallel_for(res.size(), [dt, res_dur, origin, dur](R_xlen_t begin, R_xlen_t end) {
+    for (R_xlen_t i=begin; i < end; ++i) {
+      res_dur[i] = floor_duration(dt[i], dur, origin);
     }
-  }  
+  });
   
   return assignS4("nanotime", res, "integer64");
 }
+
+
+// bucket ordinals: instead of the rounded values, return for each element the 1-based index of
+// its bucket in the grid, together with the grid itself from its start to the last bucket used.
+
+// 'ord' contains the 0-based ordinals, with 'NA_INTEGER64' for 'NA':
+static SEXP ordinalsToR(const std::vector<int64_t>& ord, int64_t nbuckets, bool as_int64) {
+  const R_xlen_t n = ord.size();
+  if (as_int64) {
+    Rcpp::NumericVector res(n);
+    auto res_p = reinterpret_cast<int64_t*>(res.begin());
+    parallel_for(n, [&ord, res_p](R_xlen_t begin, R_xlen_t end) {
+      for (R_xlen_t i=begin; i<end; ++i) {
+        res_p[i] = ord[i] == NA_INTEGER64 ? NA_INTEGER64 : ord[i] + 1;
+      }
+    });
+    res.attr("class") = "integer64";
+    return res;
+  } else {
+    if (nbuckets > std::numeric_limits<int>::max()) {
+      Rcpp::stop("too many buckets for 32-bit ordinals, use 'int64=TRUE'");
+    }
+    Rcpp::IntegerVector res(n);
+    auto res_p = res.begin();
+    parallel_for(n, [&ord, res_p](R_xlen_t begin, R_xlen_t end) {
+      for (R_xlen_t i=begin; i<end; ++i) {
+        res_p[i] = ord[i] == NA_INTEGER64 ? NA_INTEGER : static_cast<int>(ord[i] + 1);
+      }
+    });
+    return res;
+  }
+}
+
+
+static Rcpp::List makeOrdinalsResult(const std::vector<int64_t>& ord, Rcpp::NumericVector& grid_v, bool as_int64) {
+  return Rcpp::List::create(Rcpp::Named("idx")  = ordinalsToR(ord, grid_v.size(), as_int64),
+                            Rcpp::Named("grid") = assignS4("nanotime", grid_v, "integer64"));
+}
+
+
+static bool getInt64(const Rcpp::LogicalVector& int64_v) {
+  if (int64_v.size() != 1 || int64_v[0] == NA_LOGICAL) {
+    Rcpp::stop("'int64' must be a non-NA logical scalar");
+  }
+  return int64_v[0];
+}
+
+
+// the grid is allocated in full, empty buckets included, so that a fine precision over a wide
+// span must be refused beforehand: the grid can't be longer than both 'x' and what 32-bit
+// ordinals can count. 'first' and 'last' are the ordinals of the first and last buckets:
+static R_xlen_t getGridLength(int64_t first, int64_t last, R_xlen_t n, bool as_int64) {
+  const uint64_t ngrid = static_cast<uint64_t>(last) - static_cast<uint64_t>(first) + 1;
+  const uint64_t int_max = std::numeric_limits<int>::max();
+  if (ngrid > std::max(static_cast<uint64_t>(n), int_max)) {
+    Rcpp::stop("too many buckets in the grid, use a coarser 'precision'");
+  }
+  if (!as_int64 && ngrid > int_max) {
+    Rcpp::stop("too many buckets for 32-bit ordinals, use 'int64=TRUE'");
+  }
+  return static_cast<R_xlen_t>(ngrid);
+}
+
+
+// [[Rcpp::export]]
+Rcpp::List floor_idx_impl(SEXP                       nt_s,        // vector of 'nanotime'
+                          const Rcpp::NumericVector& dur_v,       // scalar duration
+                          const Rcpp::NumericVector& orig_v,      // origin
+                          const Rcpp::LogicalVector& int64_v) {   // return 64-bit ordinals
+  if (orig_v.size() > 1) Rcpp::stop("'origin' must be scalar");
+  if (dur_v.size() != 1) Rcpp::stop("'precision' must be scalar");
+  const auto as_int64 = getInt64(int64_v);
+
+  int64_t dur; memcpy(&dur, reinterpret_cast<const char*>(&dur_v[0]), sizeof(int64_t));
+  if (dur <= 0) {
+    Rcpp::stop("'precision' must be strictly positive");
+  }
+
+  const R_xlen_t n = XLENGTH(nt_s);
+  const auto dt = readOnly<int64_t>(nt_s);
+  const auto origin = orig_v.size() ? *reinterpret_cast<const int64_t*>(&orig_v[0]) : 0;
+
+  // the floor is monotonic, so the grid goes from the floor of the smallest element to the
+  // floor of the largest one:
+  int64_t tmin = std::numeric_limits<int64_t>::max(), tmax = NA_INTEGER64;
+  for (R_xlen_t i=0; i<n; ++i) {
+    if (dt[i] == NA_INTEGER64) continue;
+    tmin = std::min(tmin, dt[i]);
+    tmax = std::max(tmax, dt[i]);
+  }
+  const bool empty   = tmax == NA_INTEGER64;
+  const auto gridmin = empty ? 0 : floor_duration(tmin, dur, origin);
+  // the difference of the floors is a multiple of 'dur', but may not fit in 'int64_t':
+  const auto ngrid   = empty ? 0 : getGridLength(0, (static_cast<uint64_t>(floor_duration(tmax, dur, origin)) -
+                                                     static_cast<uint64_t>(gridmin)) / dur, n, as_int64);
+
+  std::vector<int64_t> ord(n);
+  parallel_for(n, [dt, dur, origin, gridmin, &ord](R_xlen_t begin, R_xlen_t end) {
+    for (R_xlen_t i=begin; i<end; ++i) {
+      ord[i] = dt[i] == NA_INTEGER64 ? NA_INTEGER64 : (floor_duration(dt[i], dur, origin) - gridmin) / dur;
+    }
+  });
+
+  Rcpp::NumericVector grid_v(ngrid);
+  auto grid = reinterpret_cast<int64_t*>(grid_v.begin());
+  for (R_xlen_t k=0; k<ngrid; ++k) grid[k] = gridmin + k * dur;
+
+  return makeOrdinalsResult(ord, grid_v, as_int64);
+}
+
+
+// [[Rcpp::export]]
+Rcpp::List floor_tz_idx_impl(SEXP                         nt_s,           // vector of 'nanotime'
+                             const Rcpp::ComplexVector&   prd_v,          // scalar period
+                             const Rcpp::NumericVector&   orig_v,         // origin
+                             const Rcpp::CharacterVector& tz_v,           // scalar timezone
+                             const Rcpp::IntegerVector&   week_start_v,   // first day of the week, 0 is Sunday
+                             const Rcpp::LogicalVector&   epoch_v,        // is the grid anchored on the epoch
+                             const Rcpp::LogicalVector&   int64_v) {      // return 64-bit ordinals
+  if (orig_v.size() > 1) {
+    Rcpp::stop("'origin' must be scalar");
+  }
+  if (tz_v.size() > 1) {
+    Rcpp::stop("'tz' must be scalar");
+  }
+  const auto week_start = getWeekStart(week_start_v);
+  if (epoch_v.size() != 1 || epoch_v[0] == NA_LOGICAL) {
+    Rcpp::stop("'epoch' must be a non-NA logical scalar");
+  }
+  if (epoch_v[0] && orig_v.size()) {
+    Rcpp::stop("'origin' cannot be specified for an epoch-anchored grid");
+  }
+  if (prd_v.size() != 1) {
+    Rcpp::stop("'precision' must be scalar");
+  }
+  const auto as_int64 = getInt64(int64_v);
+
+  const auto tz = Rcpp::as<std::string>(tz_v[0]);
+  period prd; memcpy(&prd, reinterpret_cast<const char*>(&prd_v[0]), sizeof(period));
+
+  // period must be strictly positive
+  if ((prd.getMonths() < 0 || prd.getDays() < 0 || prd.getDuration() < duration::zero()) ||
+      prd == period{0, 0, duration::zero()}) {
+    Rcpp::stop("'precision' must be strictly positive");
+  }
+
+  const R_xlen_t n = XLENGTH(nt_s);
+  const auto dt = readOnly<dtime>(nt_s);
+  std::vector<int64_t> ord(n);
+
+  if (epoch_v[0]) {
+    const EpochGrid grid(prd, week_start);
+    if (n) getOffsetCnv(dt[0], tz);  // validate 'tz' on the main thread
+    epochindex(dt, n, grid, tz, ord.data());
+
+    int64_t imin = std::numeric_limits<int64_t>::max(), imax = NA_INTEGER64;
+    dtime hint;                 // a time in the first bucket
+    for (R_xlen_t i=0; i<n; ++i) {
+      if (ord[i] == NA_INTEGER64) continue;
+      if (ord[i] < imin) {
+        imin = ord[i];
+        hint = dt[i];
+      }
+      imax = std::max(imax, ord[i]);
+    }
+    const auto ngrid = imax == NA_INTEGER64 ? 0 : getGridLength(imin, imax, n, as_int64);
+    for (auto& i : ord) {
+      if (i != NA_INTEGER64) i -= imin;
+    }
+
+    Rcpp::NumericVector grid_v(ngrid);
+    auto grid_p = reinterpret_cast<dtime*>(grid_v.begin());
+    for (R_xlen_t k=0; k<ngrid; ++k) {
+      grid_p[k] = grid.start(imin + k, tz, k ? grid_p[k-1] : hint);
+    }
+
+    return makeOrdinalsResult(ord, grid_v, as_int64);
+  }
+
+  if (n == 0) {
+    Rcpp::NumericVector grid_v(0);
+    return makeOrdinalsResult(ord, grid_v, as_int64);
+  }
+
+  dtime origin;
+  if (orig_v.size()) {
+    origin = *reinterpret_cast<const dtime*>(&orig_v[0]);
+    if (dt[0] > plus(origin, prd, tz)) {
+      Rcpp::stop("when specifying 'origin', the first interval must contain at least one observation");
+    }
+  }
+
+  const auto grid = orig_v.size() ?
+    makegrid(origin, true,  dt[n-1], prd, tz, week_start) :
+    makegrid(dt[0],  false, dt[n-1], prd, tz, week_start);
+
+  floortogrid(dt, n, grid, [&ord](R_xlen_t ix, size_t k) { ord[ix] = k; });
+
+  // 'dt' is sorted, so the last element is in the last bucket used:
+  Rcpp::NumericVector grid_v(ord[n-1] + 1);
+  std::copy(grid.begin(), grid.begin() + grid_v.size(), reinterpret_cast<dtime*>(grid_v.begin()));
+
+  return makeOrdinalsResult(ord, grid_v, as_int64);
+}
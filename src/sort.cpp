@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <Rcpp.h>
+#include "nanotime/globals.hpp"
+#include "nanotime/radix.hpp"
+
+
+using namespace nanotime;
+
+
+// Radix sort and order of 'nanotime' and 'nanoduration', which are both 64-bit integers
+// stored in a numeric vector.
+
+static int getNaLast(const Rcpp::LogicalVector& na_last_v) {
+  if (na_last_v.size() != 1) Rcpp::stop("argument 'na.last' must be a logical scalar");
+  return na_last_v[0];
+}
+
+
+// the order of the non-NA values, with the NA, which have the smallest key, moved last if
+// 'na_last' is TRUE, first if it is FALSE, or removed if it is NA:
+static std::vector<R_xlen_t> int64_order(SEXP nv,
+                                         const Rcpp::LogicalVector& decreasing_v,
+                                         const Rcpp::LogicalVector& na_last_v) {
+  if (decreasing_v.size() == 0) Rcpp::stop("argument 'decreasing' cannot have length 0");
+  const bool decreasing = decreasing_v[0];
+  const int na_last = getNaLast(na_last_v);
+
+  const auto v = readOnly<std::int64_t>(nv);
+  const R_xlen_t n = XLENGTH(nv);
+  auto idx = radix_order(v, n, decreasing);
+
+  const R_xlen_t nna = std::count(v, v + n, NA_INTEGER64);
+  if (nna == 0) return idx;
+  if (na_last == NA_LOGICAL) {
+    if (decreasing) idx.resize(n - nna);
+    else idx.erase(idx.begin(), idx.begin() + nna);
+  } else if (decreasing && !na_last) {
+    std::rotate(idx.begin(), idx.end() - nna, idx.end());
+  } else if (!decreasing && na_last) {
+    std::rotate(idx.begin(), idx.begin() + nna, idx.end());
+  }
+  return idx;
+}
+
+
+// [[Rcpp::export]]
+Rcpp::NumericVector nanotime_sort_impl(SEXP nv,
+                                       const Rcpp::LogicalVector decreasing_v,
+                                       const Rcpp::LogicalVector na_last_v) {
+  const auto idx = int64_order(nv, decreasing_v, na_last_v);
+  const auto v = readOnly<std::int64_t>(nv);
+  Rcpp::NumericVector res(idx.size());
+  auto r = reinterpret_cast<std::int64_t*>(res.begin());
+  for (size_t i=0; i<idx.size(); ++i) {
+    r[i] = v[idx[i]];
+  }
+  Rf_copyMostAttrib(nv, res);
+  return res;
+}
+
+
+// [[Rcpp::export]]
+SEXP nanotime_order_impl(SEXP nv,
+                         const Rcpp::LogicalVector decreasing_v,
+                         const Rcpp::LogicalVector na_last_v) {
+  return radix_permutation(int64_order(nv, decreasing_v, na_last_v));
+}
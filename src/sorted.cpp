@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <climits>
+#include <Rcpp.h>
+#include <R_ext/Altrep.h>
+#include <R_ext/Rdynload.h>
+#include "nanotime/globals.hpp"
+#include "nanotime/interval.hpp"
+#include "nanotime/utilities.hpp"
+
+
+using namespace nanotime;
+
+
+// Sortedness metadata for 'nanotime' and 'nanoival' vectors. A vector
+// that is produced sorted is wrapped in an ALTREP class whose 'data1'
+// is the payload and whose 'data2' is a flag; the flag is cleared as
+// soon as a writable pointer to the payload is handed out, and it is
+// lost on duplication, so it can only ever be a conservative
+// statement. The kernels read their arguments through 'REAL_RO' and
+// 'COMPLEX_RO', so that reading the vector keeps the flag. The flag is
+// not exposed through 'Is_sorted', since R would take it to describe
+// the order of the 'double' or 'complex' values rather than of the
+// 64-bit integers and intervals they hold.
+
+static R_altrep_class_t sorted_real_class;
+static R_altrep_class_t sorted_complex_class;
+
+
+static bool isSortedWrapper(SEXP x) {
+  return ALTREP(x) && (R_altrep_inherits(x, sorted_real_class) ||
+                       R_altrep_inherits(x, sorted_complex_class));
+}
+
+static bool hasNA(SEXP x) {
+  const R_xlen_t n = XLENGTH(x);
+  if (TYPEOF(x) == REALSXP) {
+    const std::int64_t* v = reinterpret_cast<const std::int64_t*>(REAL_RO(x));
+    for (R_xlen_t i=0; i<n; ++i) {
+      if (v[i] == NA_INTEGER64) return true;
+    }
+  } else {
+    const interval* v = reinterpret_cast<const interval*>(COMPLEX_RO(x));
+    for (R_xlen_t i=0; i<n; ++i) {
+      if (v[i].isNA()) return true;
+    }
+  }
+  return false;
+}
+
+
+// ALTREP methods, shared by the two classes:
+
+static R_xlen_t sorted_Length(SEXP x) {
+  return XLENGTH(R_altrep_data1(x));
+}
+
+static SEXP sorted_Duplicate(SEXP x, Rboolean deep) {
+  // let R make a standard copy, which does not carry the flag:
+  return NULL;
+}
+
+static void* sorted_Dataptr(SEXP x, Rboolean writeable) {
+  SEXP data1 = R_altrep_data1(x);
+  if (writeable) {
+    if (MAYBE_SHARED(data1)) {
+      data1 = Rf_duplicate(data1);
+      R_set_altrep_data1(x, data1);
+    }
+    LOGICAL(R_altrep_data2(x))[0] = FALSE;
+    return TYPEOF(data1) == REALSXP ? static_cast<void*>(REAL(data1)) : static_cast<void*>(COMPLEX(data1));
+  }
+  return TYPEOF(data1) == REALSXP ?
+    const_cast<void*>(static_cast<const void*>(REAL_RO(data1))) :
+    const_cast<void*>(static_cast<const void*>(COMPLEX_RO(data1)));
+}
+
+static const void* sorted_Dataptr_or_null(SEXP x) {
+  SEXP data1 = R_altrep_data1(x);
+  return TYPEOF(data1) == REALSXP ?
+    static_cast<const void*>(REAL_RO(data1)) : static_cast<const void*>(COMPLEX_RO(data1));
+}
+
+static double sorted_real_Elt(SEXP x, R_xlen_t i) {
+  return REAL_ELT(R_altrep_data1(x), i);
+}
+
+static Rcomplex sorted_complex_Elt(SEXP x, R_xlen_t i) {
+  return COMPLEX_ELT(R_altrep_data1(x), i);
+}
+
+
+// [[Rcpp::init]]
+void nanotime_init_sorted(DllInfo* dll) {
+  sorted_real_class = R_make_altreal_class("sorted_nanotime", "nanotime", dll);
+  R_set_altrep_Length_method(sorted_real_class, sorted_Length);
+  R_set_altrep_Duplicate_method(sorted_real_class, sorted_Duplicate);
+  R_set_altvec_Dataptr_method(sorted_real_class, sorted_Dataptr);
+  R_set_altvec_Dataptr_or_null_method(sorted_real_class, sorted_Dataptr_or_null);
+  R_set_altreal_Elt_method(sorted_real_class, sorted_real_Elt);
+
+  sorted_complex_class = R_make_altcomplex_class("sorted_nanoival", "nanotime", dll);
+  R_set_altrep_Length_method(sorted_complex_class, sorted_Length);
+  R_set_altrep_Duplicate_method(sorted_complex_class, sorted_Duplicate);
+  R_set_altvec_Dataptr_method(sorted_complex_class, sorted_Dataptr);
+  R_set_altvec_Dataptr_or_null_method(sorted_complex_class, sorted_Dataptr_or_null);
+  R_set_altcomplex_Elt_method(sorted_complex_class, sorted_complex_Elt);
+}
+
+
+bool nanotime::isKnownSorted(SEXP x) {
+  return isSortedWrapper(x) && LOGICAL(R_altrep_data2(x))[0];
+}
+
+
+// [[Rcpp::export]]
+bool nano_is_sorted_impl(SEXP x) {
+  return isKnownSorted(x);
+}
+
+
+// The 1-based index of the first element of 'x' that is 'NA' or that is
+// smaller than, or if 'strictly' not larger than, the element before
+// it; 0 if there is none. 'bad(i)' says if element 'i' is such an
+// element, for 'i >= 1'. The comparisons of a block are or-ed without
+// branches, which vectorises, and the block is only scanned again to
+// find the index once it is known to hold one.
+static const R_xlen_t UNSORTED_BLOCK = 1024;
+
+template <typename F>
+static R_xlen_t firstUnsorted(R_xlen_t n, bool na0, F bad) {
+  if (n == 0) return 0;
+  if (na0) return 1;
+  for (R_xlen_t b=1; b<n; b+=UNSORTED_BLOCK) {
+    const R_xlen_t e = std::min(n, b + UNSORTED_BLOCK);
+    bool any = false;
+    for (R_xlen_t i=b; i<e; ++i) any |= bad(i);
+    if (any) {
+      for (R_xlen_t i=b; i<e; ++i) {
+        if (bad(i)) return i + 1;
+      }
+    }
+  }
+  return 0;
+}
+
+// [[Rcpp::export]]
+SEXP nano_first_unsorted_impl(SEXP x, const Rcpp::LogicalVector strictly_v) {
+  if (strictly_v.size() == 0) {
+    Rcpp::stop("argument 'strictly' cannot have length 0");
+  }
+  if (strictly_v[0] == NA_LOGICAL) {
+    Rcpp::stop("argument 'strictly' must be TRUE or FALSE");
+  }
+  const bool strictly = strictly_v[0];
+  const R_xlen_t n = XLENGTH(x);
+  R_xlen_t res;
+  if (TYPEOF(x) == REALSXP && (Rf_inherits(x, "nanotime") || Rf_inherits(x, "nanoduration"))) {
+    const std::int64_t* v = reinterpret_cast<const std::int64_t*>(REAL_RO(x));
+    res = firstUnsorted(n, n && v[0] == NA_INTEGER64, [v, strictly](R_xlen_t i) {
+      return (v[i] == NA_INTEGER64) | (v[i-1] > v[i]) | (strictly & (v[i-1] == v[i]));
+    });
+  } else if (TYPEOF(x) == CPLXSXP && Rf_inherits(x, "nanoival")) {
+    // intervals are ordered as their (start key, end key) pairs:
+    const interval* v = reinterpret_cast<const interval*>(COMPLEX_RO(x));
+    res = firstUnsorted(n, n && v[0].isNA(), [v, strictly](R_xlen_t i) {
+      const std::int64_t sk1 = start_key(v[i-1]), sk2 = start_key(v[i]);
+      const std::int64_t ek1 = end_key(v[i-1]),   ek2 = end_key(v[i]);
+      return v[i].isNA() | (sk1 > sk2) | ((sk1 == sk2) & ((ek1 > ek2) | (strictly & (ek1 == ek2))));
+    });
+  } else {
+    Rcpp::stop("argument must be a 'nanotime', 'nanoduration' or 'nanoival'");
+  }
+  if (n > INT_MAX) {
+    return Rcpp::wrap(static_cast<double>(res));
+  }
+  return Rcpp::wrap(static_cast<int>(res));
+}
+
+
+// 'x' with the flag set, provided it has no 'NA'; the caller guarantees
+// that it is sorted:
+// [[Rcpp::export]]
+SEXP nano_mark_sorted_impl(SEXP x) {
+  if ((TYPEOF(x) != REALSXP && TYPEOF(x) != CPLXSXP) || XLENGTH(x) < 2 || hasNA(x)) {
+    return x;
+  }
+  if (isSortedWrapper(x)) {
+    LOGICAL(R_altrep_data2(x))[0] = TRUE;
+    return x;
+  }
+  Rcpp::LogicalVector flag = Rcpp::LogicalVector::create(true);
+  Rcpp::RObject res = R_new_altrep(TYPEOF(x) == REALSXP ? sorted_real_class : sorted_complex_class,
+                                   x, flag);
+  SHALLOW_DUPLICATE_ATTRIB(res, x);
+  return res;
+}
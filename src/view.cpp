@@ -0,0 +1,185 @@
+#include <cmath>
+#include <cstring>
+#include <Rcpp.h>
+#include <R_ext/Altrep.h>
+#include <R_ext/Rdynload.h>
+#include "nanotime/utilities.hpp"
+
+
+// Views on a contiguous slice of a 'nanotime', 'nanoduration',
+// 'nanoival' or 'nanoperiod' vector. A view is an ALTREP object whose
+// 'data1' is the parent vector and whose 'data2' holds the offset and
+// the length of the slice; reading it reads the parent in place. The
+// slice is copied into a vector of its own, which then replaces the
+// parent in 'data1' while 'data2' is set to 'NULL', as soon as a
+// writable pointer is asked for; the kernels read their arguments
+// through 'REAL_RO' and 'COMPLEX_RO' so that they don't. A view keeps
+// its whole parent alive, so only slices that are long enough for the
+// copy to matter are returned as views.
+
+static R_altrep_class_t view_real_class;
+static R_altrep_class_t view_complex_class;
+
+static const R_xlen_t VIEW_MIN_LENGTH = 4096;
+
+
+static bool isView(SEXP x) {
+  return ALTREP(x) && (R_altrep_inherits(x, view_real_class) ||
+                       R_altrep_inherits(x, view_complex_class));
+}
+
+static size_t eltSize(SEXP x) {
+  return TYPEOF(x) == REALSXP ? sizeof(double) : sizeof(Rcomplex);
+}
+
+// offset and length of the slice of a view that is not materialised:
+static R_xlen_t viewOffset(SEXP x) { return static_cast<R_xlen_t>(REAL(R_altrep_data2(x))[0]); }
+static R_xlen_t viewLength(SEXP x) { return static_cast<R_xlen_t>(REAL(R_altrep_data2(x))[1]); }
+
+static const void* viewData(SEXP x) {
+  SEXP data1 = R_altrep_data1(x);
+  const char* p = TYPEOF(data1) == REALSXP ?
+    reinterpret_cast<const char*>(REAL_RO(data1)) : reinterpret_cast<const char*>(COMPLEX_RO(data1));
+  return R_altrep_data2(x) == R_NilValue ? p : p + viewOffset(x) * eltSize(data1);
+}
+
+static void* writableData(SEXP x) {
+  return TYPEOF(x) == REALSXP ? static_cast<void*>(REAL(x)) : static_cast<void*>(COMPLEX(x));
+}
+
+
+// ALTREP methods, shared by the two classes:
+
+static R_xlen_t view_Length(SEXP x) {
+  return R_altrep_data2(x) == R_NilValue ? XLENGTH(R_altrep_data1(x)) : viewLength(x);
+}
+
+static SEXP view_Duplicate(SEXP x, Rboolean deep) {
+  const R_xlen_t n = view_Length(x);
+  SEXP res = PROTECT(Rf_allocVector(TYPEOF(x), n));
+  if (n) memcpy(writableData(res), viewData(x), n * eltSize(x));
+  if (deep) DUPLICATE_ATTRIB(res, x); else SHALLOW_DUPLICATE_ATTRIB(res, x);
+  UNPROTECT(1);
+  return res;
+}
+
+static void* view_Dataptr(SEXP x, Rboolean writeable) {
+  if (writeable && R_altrep_data2(x) != R_NilValue) {
+    const R_xlen_t n = viewLength(x);
+    SEXP data = PROTECT(Rf_allocVector(TYPEOF(x), n));
+    if (n) memcpy(writableData(data), viewData(x), n * eltSize(x));
+    R_set_altrep_data1(x, data);
+    R_set_altrep_data2(x, R_NilValue);
+    UNPROTECT(1);
+  }
+  if (writeable) {
+    return writableData(R_altrep_data1(x));
+  }
+  return const_cast<void*>(viewData(x));
+}
+
+static const void* view_Dataptr_or_null(SEXP x) {
+  return viewData(x);
+}
+
+static double view_real_Elt(SEXP x, R_xlen_t i) {
+  return static_cast<const double*>(viewData(x))[i];
+}
+
+static Rcomplex view_complex_Elt(SEXP x, R_xlen_t i) {
+  return static_cast<const Rcomplex*>(viewData(x))[i];
+}
+
+
+// [[Rcpp::init]]
+void nanotime_init_view(DllInfo* dll) {
+  view_real_class = R_make_altreal_class("view_nanotime", "nanotime", dll);
+  R_set_altrep_Length_method(view_real_class, view_Length);
+  R_set_altrep_Duplicate_method(view_real_class, view_Duplicate);
+  R_set_altvec_Dataptr_method(view_real_class, view_Dataptr);
+  R_set_altvec_Dataptr_or_null_method(view_real_class, view_Dataptr_or_null);
+  R_set_altreal_Elt_method(view_real_class, view_real_Elt);
+
+  view_complex_class = R_make_altcomplex_class("view_nanoival", "nanotime", dll);
+  R_set_altrep_Length_method(view_complex_class, view_Length);
+  R_set_altrep_Duplicate_method(view_complex_class, view_Duplicate);
+  R_set_altvec_Dataptr_method(view_complex_class, view_Dataptr);
+  R_set_altvec_Dataptr_or_null_method(view_complex_class, view_Dataptr_or_null);
+  R_set_altcomplex_Elt_method(view_complex_class, view_complex_Elt);
+}
+
+
+// the first element, 1-based, of the range of consecutive indices
+// that 'idx' is, or 0 if it is not such a range within '[1, n]'; the
+// index is read by regions so that a compact sequence 'a:b' is not
+// expanded:
+static R_xlen_t rangeStart(SEXP idx, R_xlen_t n) {
+  const R_xlen_t m = XLENGTH(idx);
+  if (m == 0 || (TYPEOF(idx) != INTSXP && TYPEOF(idx) != REALSXP)) return 0;
+  const double first = TYPEOF(idx) == INTSXP ? INTEGER_ELT(idx, 0) : REAL_ELT(idx, 0);
+  if (!(first >= 1 && first + (m - 1) <= n) || first != std::floor(first)) return 0;   // also rejects 'NA'
+
+  const R_xlen_t BLOCK = 512;
+  int ibuf[BLOCK];
+  double dbuf[BLOCK];
+  for (R_xlen_t b=0; b<m; b+=BLOCK) {
+    bool ok = true;
+    if (TYPEOF(idx) == INTSXP) {
+      const R_xlen_t len = INTEGER_GET_REGION(idx, b, BLOCK, ibuf);
+      for (R_xlen_t i=0; i<len; ++i) ok &= ibuf[i] == first + b + i;
+    } else {
+      const R_xlen_t len = REAL_GET_REGION(idx, b, BLOCK, dbuf);
+      for (R_xlen_t i=0; i<len; ++i) ok &= dbuf[i] == first + b + i;
+    }
+    if (!ok) return 0;
+  }
+  return static_cast<R_xlen_t>(first);
+}
+
+
+SEXP nanotime::sliceView(SEXP x, SEXP idx) {
+  if (TYPEOF(x) != REALSXP && TYPEOF(x) != CPLXSXP) return R_NilValue;
+  const R_xlen_t len = XLENGTH(idx);
+  if (len < VIEW_MIN_LENGTH) return R_NilValue;
+  const R_xlen_t from = rangeStart(idx, XLENGTH(x));
+  if (from == 0) return R_NilValue;
+
+  // a view on a view is a view on the same parent:
+  SEXP parent = x;
+  R_xlen_t offset = from - 1;
+  if (isView(x) && R_altrep_data2(x) != R_NilValue) {
+    parent = R_altrep_data1(x);
+    offset += viewOffset(x);
+  }
+
+  SEXP info = PROTECT(Rf_allocVector(REALSXP, 2));
+  REAL(info)[0] = static_cast<double>(offset);
+  REAL(info)[1] = static_cast<double>(len);
+  SEXP res = PROTECT(R_new_altrep(TYPEOF(x) == REALSXP ? view_real_class : view_complex_class,
+                                  parent, info));
+
+  // the attributes of the result of the subset kernels: class and names
+  Rf_setAttrib(res, R_ClassSymbol, Rf_getAttrib(x, R_ClassSymbol));
+  SEXP s3class = Rf_install(".S3Class");
+  if (Rf_getAttrib(x, s3class) != R_NilValue) {
+    Rf_setAttrib(res, s3class, Rf_getAttrib(x, s3class));
+  }
+  SEXP names = Rf_getAttrib(x, R_NamesSymbol);
+  if (names != R_NilValue) {
+    SEXP res_names = PROTECT(Rf_allocVector(STRSXP, len));
+    for (R_xlen_t i=0; i<len; ++i) {
+      SET_STRING_ELT(res_names, i, STRING_ELT(names, from - 1 + i));
+    }
+    Rf_setAttrib(res, R_NamesSymbol, res_names);
+    UNPROTECT(1);
+  }
+  res = Rf_asS4(res, TRUE, FALSE);
+  UNPROTECT(2);
+  return res;
+}
+
+
+// [[Rcpp::export]]
+bool nano_is_view_impl(SEXP x) {
+  return isView(x) && R_altrep_data2(x) != R_NilValue;
+}